@@ -0,0 +1,988 @@
+// Yutong Ye 12012842
+
+/*
+Lexer.cpp is the scanner behind Lexer.h: the character tables, the scanner tables (DFA) for both dialects, the run scanners and the
+keyword table. Everything here except the functions declared in Lexer.h is static, so it can be linked into any program.
+*/
+
+/*
+use #include <stdio.h> for EOF,
+#include <string.h> to work with strings like copying or comparing them,
+and #include "Lexer.h" for the Lexer, LexToken and TokenType every program shares.
+*/
+#include <stdio.h>
+#include <string.h>
+#include "Lexer.h"
+/*
+use #include <stdlib.h> for the block buffer used when a file can't be mapped,
+the POSIX headers <sys/mman.h>, <sys/stat.h>, <fcntl.h> and <unistd.h> to map the input file straight into memory,
+and <errno.h> to tell an interrupted read from a failed one.
+*/
+#include <stdlib.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+//With -DCOLLECT_STATS, use #include <time.h> for clock_gettime(), which times the phases of a scan.
+#ifdef COLLECT_STATS
+#include <time.h>
+#endif
+//On x86 compilers, use #include <immintrin.h> for the SSE2/AVX2 instructions that skip long runs of blanks, letters and digits.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define HAVE_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+/* 
+Internal function declarations 
+*/
+
+/* 
+These three functions help prepare characters so the lexical analyzer can correctly build tokens.
+getChar() reads and classifies characters, getNonBlank() skips spaces, 
+and addChar() collects valid characters into the lexeme string.
+*/
+static void addChar(Lexer *lx);
+static void getChar(Lexer *lx);
+static void getNonBlank(Lexer *lx);
+
+/*
+selectRunScanners() picks the fastest run scanner this CPU supports (AVX2, SSE2, or plain C), 
+and addRun() uses it to add a whole run of identifier characters or digits to the lexeme at once.
+*/
+static void selectRunScanners();
+static void addRun(Lexer *lx, int kind);
+
+/*
+runDfa() follows the scanner table from a given state, adding characters to the lexeme until no transition is left,
+and returns the state it stopped in.
+*/
+static int runDfa(Lexer *lx, int state);
+
+/*
+Declare lex(); because it’s the main function that reads characters from the input 
+and builds valid tokens like identifiers, numbers, or operators, returning a token type so the parser knows what to do next.
+*/
+static TokenType lex(Lexer *lx);
+
+
+/* Character classes 
+Define these to categorize each character as a letter, digit, blank, one of the operator or separator characters, 
+or anything else, so the lexical analyzer can drive its scanner table with a single lookup per character.
+*/
+#define LETTER            0
+#define DIGIT             1
+#define BLANK             2    // space, \t, \n, \v, \f, \r
+#define DOT_CHAR          3    // .
+#define LBRACKET_CHAR     4    // [
+#define RBRACKET_CHAR     5    // ]
+#define PLUS_CHAR         6    // +
+#define MINUS_CHAR        7    // -
+#define STAR_CHAR         8    // *
+#define SLASH_CHAR        9    // /
+#define PERCENT_CHAR      10   // %
+#define CARET_CHAR        11   // ^
+#define EQUAL_CHAR        12   // =
+#define TILDE_CHAR        13   // ~
+#define LPAREN_CHAR       14   // (
+#define RPAREN_CHAR       15   // )
+#define LBRACE_CHAR       16   // {
+#define RBRACE_CHAR       17   // }
+#define COMMA_CHAR        18   // ,
+#define SEMICOLON_CHAR    19   // ;
+#define OTHER_CHAR        20
+#define END_CHAR          21   // end of input
+//These are only used by the expression dialect; the C dialect classifies them as OTHER_CHAR.
+#define LESS_CHAR         22   // <
+#define GREATER_CHAR      23   // >
+#define BANG_CHAR         24   // !
+#define AMP_CHAR          25   // &
+#define PIPE_CHAR         26   // |
+#define NUM_CHAR_CLASSES  27
+
+/******************************************************/
+/* 
+Scanner tables 
+*/
+
+/*
+charClassTables maps every possible byte to its character class, one table per dialect, so getChar() classifies a character with one
+array lookup instead of a chain of range compares. Only the C-locale blanks count as BLANK, matching isspace().
+In the C dialect a 0xFF byte maps to END_CHAR because getc() stored into a char always read it as EOF. The expression dialect
+counts '_' as a letter and gives the relational and boolean operator characters their own classes; only the C dialect has ~ and ;.
+*/
+struct CharClassTable {
+    unsigned char cls[256];
+};
+
+constexpr CharClassTable buildCharClassTable(int dialect) {
+    CharClassTable t = {};
+    for (int c = 0; c < 256; c++) t.cls[c] = OTHER_CHAR;
+    for (int c = 'a'; c <= 'z'; c++) t.cls[c] = LETTER;
+    for (int c = 'A'; c <= 'Z'; c++) t.cls[c] = LETTER;
+    for (int c = '0'; c <= '9'; c++) t.cls[c] = DIGIT;
+    t.cls[(unsigned char)' '] = BLANK;
+    for (int c = '\t'; c <= '\r'; c++) t.cls[c] = BLANK;
+    t.cls[(unsigned char)'+'] = PLUS_CHAR;
+    t.cls[(unsigned char)'-'] = MINUS_CHAR;
+    t.cls[(unsigned char)'*'] = STAR_CHAR;
+    t.cls[(unsigned char)'/'] = SLASH_CHAR;
+    t.cls[(unsigned char)'='] = EQUAL_CHAR;
+    t.cls[(unsigned char)'('] = LPAREN_CHAR;
+    t.cls[(unsigned char)')'] = RPAREN_CHAR;
+    t.cls[(unsigned char)'.'] = DOT_CHAR;
+    t.cls[(unsigned char)'['] = LBRACKET_CHAR;
+    t.cls[(unsigned char)']'] = RBRACKET_CHAR;
+    t.cls[(unsigned char)'%'] = PERCENT_CHAR;
+    t.cls[(unsigned char)'^'] = CARET_CHAR;
+    t.cls[(unsigned char)'{'] = LBRACE_CHAR;
+    t.cls[(unsigned char)'}'] = RBRACE_CHAR;
+    t.cls[(unsigned char)','] = COMMA_CHAR;
+    if (dialect == LEX_EXPR) {
+        t.cls[(unsigned char)'_'] = LETTER;
+        t.cls[(unsigned char)'<'] = LESS_CHAR;
+        t.cls[(unsigned char)'>'] = GREATER_CHAR;
+        t.cls[(unsigned char)'!'] = BANG_CHAR;
+        t.cls[(unsigned char)'&'] = AMP_CHAR;
+        t.cls[(unsigned char)'|'] = PIPE_CHAR;
+        return t;
+    }
+    t.cls[(unsigned char)'~'] = TILDE_CHAR;
+    t.cls[(unsigned char)';'] = SEMICOLON_CHAR;
+    t.cls[0xFF] = END_CHAR;
+    return t;
+}
+
+constexpr CharClassTable charClassTables[LEX_DIALECTS] = {buildCharClassTable(LEX_C), buildCharClassTable(LEX_EXPR)};
+
+/*
+Scanner (DFA) states. lex() starts in S_START and keeps following transitions while the next character allows one;
+the state it stops in decides the token code. S_ARRAY_OPEN is entered separately once an identifier turns out not to be a keyword.
+*/
+#define S_START           0
+#define S_IDENT           1
+#define S_INT             2
+#define S_INT_DOT         3
+#define S_FLOAT           4
+#define S_ARRAY_OPEN      5
+#define S_ARRAY_INDEX     6
+#define S_ARRAY           7
+#define S_PLUS            8
+#define S_INC             9
+#define S_ADD_ASSIGN      10
+#define S_MINUS           11
+#define S_DEC             12
+#define S_SUB_ASSIGN      13
+#define S_STAR            14
+#define S_MULT_ASSIGN     15
+#define S_SLASH           16
+#define S_DIV_ASSIGN      17
+#define S_PERCENT         18
+#define S_MOD_ASSIGN      19
+#define S_CARET           20
+#define S_POW_ASSIGN      21
+#define S_TILDE           22
+#define S_ASSIGN          23
+#define S_LEFT_PAREN      24
+#define S_RIGHT_PAREN     25
+#define S_LEFT_BRACE      26
+#define S_RIGHT_BRACE     27
+#define S_COMMA           28
+#define S_SEMICOLON       29
+#define S_UNKNOWN         30
+//These states are only reachable in the expression dialect.
+#define S_EQUAL           31
+#define S_BANG            32
+#define S_NOT_EQUAL       33
+#define S_LESS            34
+#define S_LESS_EQUAL      35
+#define S_GREATER         36
+#define S_GREATER_EQUAL   37
+#define S_AMP             38
+#define S_AND             39
+#define S_PIPE            40
+#define S_OR              41
+#define NUM_STATES        42
+
+/*
+DfaTable holds the transition table and the token type for each state. A next state of S_START means "no transition",
+since no token ever goes back to the start state.
+*/
+struct DfaTable {
+    unsigned char next[NUM_STATES][NUM_CHAR_CLASSES];
+    TokenType accept[NUM_STATES];
+    int selfRun[NUM_STATES];
+};
+
+/*
+Run kinds name the character sets that some states loop on. A state with a run kind can swallow the whole run
+in one step with a run scanner instead of going around the table once per character.
+*/
+#define NO_RUN            0
+#define IDENT_RUN         1    // letters and digits
+#define DIGIT_RUN         2    // digits
+#define BLANK_RUN         3    // blanks, used by getNonBlank()
+#define NUM_RUN_KINDS     4
+
+//state() records which token a state stands for, and edge() adds a transition out of a state for one character class.
+constexpr void state(DfaTable &t, int s, TokenType type) {
+    t.accept[s] = type;
+}
+
+constexpr void edge(DfaTable &t, int from, int cls, int to) {
+    t.next[from][cls] = to;
+}
+
+//loop() makes a state loop on every class in a run, and remembers the run kind so runDfa() can take the fast path.
+constexpr void loop(DfaTable &t, int s, int kind) {
+    edge(t, s, DIGIT, s);
+    if (kind == IDENT_RUN) edge(t, s, LETTER, s);
+    t.selfRun[s] = kind;
+}
+
+/*
+buildDfa() generates the whole scanner table of a dialect at compile time from the token rules below. Both dialects share identifiers,
+numbers, array identifiers, the arithmetic and compound assignment operators, parentheses, braces, commas and UNKNOWN; the rest of the
+rules belong to one of them.
+*/
+constexpr DfaTable buildDfa(int dialect) {
+    DfaTable t = {};
+//Identifiers start with a letter and continue with letters or digits; the keyword check happens afterwards in lex().
+    state(t, S_IDENT, IDENT);
+    edge(t, S_START, LETTER, S_IDENT);
+    loop(t, S_IDENT, IDENT_RUN);
+//Numbers are digits, optionally followed by a dot and more digits (a float); a dot without digits after it is UNKNOWN.
+    state(t, S_INT, INT_LIT);
+    edge(t, S_START, DIGIT, S_INT);
+    loop(t, S_INT, DIGIT_RUN);
+//The single-character operators and the parentheses are the same in both dialects.
+    state(t, S_PLUS, ADD_OP);
+    state(t, S_MINUS, SUB_OP);
+    state(t, S_STAR, MULT_OP);
+    state(t, S_SLASH, DIV_OP);
+    state(t, S_ASSIGN, ASSIGN_OP);
+    state(t, S_LEFT_PAREN, LEFT_PAREN);
+    state(t, S_RIGHT_PAREN, RIGHT_PAREN);
+    edge(t, S_START, PLUS_CHAR, S_PLUS);
+    edge(t, S_START, MINUS_CHAR, S_MINUS);
+    edge(t, S_START, STAR_CHAR, S_STAR);
+    edge(t, S_START, SLASH_CHAR, S_SLASH);
+    edge(t, S_START, EQUAL_CHAR, S_ASSIGN);
+    edge(t, S_START, LPAREN_CHAR, S_LEFT_PAREN);
+    edge(t, S_START, RPAREN_CHAR, S_RIGHT_PAREN);
+//Any other single character is UNKNOWN.
+    state(t, S_UNKNOWN, UNKNOWN);
+    edge(t, S_START, OTHER_CHAR, S_UNKNOWN);
+    state(t, S_INT_DOT, UNKNOWN);
+    state(t, S_FLOAT, FLOAT_LIT);
+    edge(t, S_INT, DOT_CHAR, S_INT_DOT);
+    edge(t, S_INT_DOT, DIGIT, S_FLOAT);
+    loop(t, S_FLOAT, DIGIT_RUN);
+//An identifier followed by [digits] becomes an array identifier; in C anything short of the closing ] stays an identifier.
+    state(t, S_ARRAY_OPEN, IDENT);
+    state(t, S_ARRAY_INDEX, IDENT);
+    state(t, S_ARRAY, ARRAY_ID);
+    edge(t, S_ARRAY_OPEN, DIGIT, S_ARRAY_INDEX);
+    loop(t, S_ARRAY_INDEX, DIGIT_RUN);
+    edge(t, S_ARRAY_INDEX, RBRACKET_CHAR, S_ARRAY);
+//+, -, *, / can be combined with = (+=, -=, *=, /=).
+    state(t, S_ADD_ASSIGN, ADD_ASSIGN_OP);
+    edge(t, S_PLUS, EQUAL_CHAR, S_ADD_ASSIGN);
+    state(t, S_SUB_ASSIGN, SUB_ASSIGN_OP);
+    edge(t, S_MINUS, EQUAL_CHAR, S_SUB_ASSIGN);
+    state(t, S_MULT_ASSIGN, MULT_ASSIGN_OP);
+    edge(t, S_STAR, EQUAL_CHAR, S_MULT_ASSIGN);
+    state(t, S_DIV_ASSIGN, DIV_ASSIGN_OP);
+    edge(t, S_SLASH, EQUAL_CHAR, S_DIV_ASSIGN);
+//% and ^ stand alone or are combined with = into a compound assignment.
+    state(t, S_PERCENT, MOD_OP);
+    state(t, S_MOD_ASSIGN, MOD_ASSIGN_OP);
+    edge(t, S_START, PERCENT_CHAR, S_PERCENT);
+    edge(t, S_PERCENT, EQUAL_CHAR, S_MOD_ASSIGN);
+    state(t, S_CARET, POW_OP);
+    state(t, S_POW_ASSIGN, POW_ASSIGN_OP);
+    edge(t, S_START, CARET_CHAR, S_CARET);
+    edge(t, S_CARET, EQUAL_CHAR, S_POW_ASSIGN);
+//Braces and commas are always a single character.
+    state(t, S_LEFT_BRACE, LEFT_BRACE);
+    state(t, S_RIGHT_BRACE, RIGHT_BRACE);
+    state(t, S_COMMA, COMMA);
+    edge(t, S_START, LBRACE_CHAR, S_LEFT_BRACE);
+    edge(t, S_START, RBRACE_CHAR, S_RIGHT_BRACE);
+    edge(t, S_START, COMMA_CHAR, S_COMMA);
+//A stray ., [ or ] is UNKNOWN as well.
+    edge(t, S_START, DOT_CHAR, S_UNKNOWN);
+    edge(t, S_START, LBRACKET_CHAR, S_UNKNOWN);
+    edge(t, S_START, RBRACKET_CHAR, S_UNKNOWN);
+    if (dialect == LEX_EXPR) {
+/*
+The expression dialect adds ==, !=, <, <=, >, >=, && and || and the logical not !; a single & or | is UNKNOWN. It has no ++ or --, since
+--a is two unary minuses there, and a name with an unfinished index like a[3 is UNKNOWN rather than an identifier with a bracket in it.
+*/
+        state(t, S_ARRAY_OPEN, UNKNOWN);
+        state(t, S_ARRAY_INDEX, UNKNOWN);
+        state(t, S_EQUAL, REQ_OP);
+        edge(t, S_ASSIGN, EQUAL_CHAR, S_EQUAL);
+        state(t, S_BANG, BNOT_OP);
+        state(t, S_NOT_EQUAL, RNEQ_OP);
+        edge(t, S_START, BANG_CHAR, S_BANG);
+        edge(t, S_BANG, EQUAL_CHAR, S_NOT_EQUAL);
+        state(t, S_LESS, RLT_OP);
+        state(t, S_LESS_EQUAL, RLEQ_OP);
+        edge(t, S_START, LESS_CHAR, S_LESS);
+        edge(t, S_LESS, EQUAL_CHAR, S_LESS_EQUAL);
+        state(t, S_GREATER, RGT_OP);
+        state(t, S_GREATER_EQUAL, RGEQ_OP);
+        edge(t, S_START, GREATER_CHAR, S_GREATER);
+        edge(t, S_GREATER, EQUAL_CHAR, S_GREATER_EQUAL);
+        state(t, S_AMP, UNKNOWN);
+        state(t, S_AND, BAND_OP);
+        edge(t, S_START, AMP_CHAR, S_AMP);
+        edge(t, S_AMP, AMP_CHAR, S_AND);
+        state(t, S_PIPE, UNKNOWN);
+        state(t, S_OR, BOR_OP);
+        edge(t, S_START, PIPE_CHAR, S_PIPE);
+        edge(t, S_PIPE, PIPE_CHAR, S_OR);
+        return t;
+    }
+//In C, + and - can also be doubled (++, --), ~ is the unary minus, and ; ends a statement.
+    state(t, S_INC, INC_OP);
+    edge(t, S_PLUS, PLUS_CHAR, S_INC);
+    state(t, S_DEC, DEC_OP);
+    edge(t, S_MINUS, MINUS_CHAR, S_DEC);
+    state(t, S_TILDE, UNARY_MINUS);
+    state(t, S_SEMICOLON, SEMICOLON);
+    edge(t, S_START, TILDE_CHAR, S_TILDE);
+    edge(t, S_START, SEMICOLON_CHAR, S_SEMICOLON);
+    return t;
+}
+
+constexpr DfaTable dfaTables[LEX_DIALECTS] = {buildDfa(LEX_C), buildDfa(LEX_EXPR)};
+
+/*****************************************************/
+/* 
+Input functions 
+*/
+
+//Size of each read when the input can't be mapped (pipes, empty files, or a failed mmap).
+#define INPUT_BLOCK_SIZE (1 << 20)
+
+/*
+lexer_open() maps a regular file read-only into memory, so the whole input is one pointer range the lexer owns. It returns 0 if the file
+can't be opened or read; a read error is not taken for the end of the file, so a truncated input is never scanned.
+*/
+int lexer_open(Lexer *lx, const char *path, int dialect) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return 0;
+    }
+    const char *buf = NULL;
+    size_t size = 0;
+    int mapped = 0;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map != MAP_FAILED) {
+            madvise(map, (size_t)st.st_size, MADV_SEQUENTIAL);
+            buf = (const char *)map;
+            size = (size_t)st.st_size;
+            mapped = 1;
+        }
+    }
+//If mapping wasn't possible, read the file in large blocks into one growing buffer instead of one character at a time.
+    if (!mapped) {
+        size_t cap = INPUT_BLOCK_SIZE;
+        char *block = (char *)malloc(cap);
+        ssize_t got;
+        while (block != NULL && (got = read(fd, block + size, cap - size)) != 0) {
+            if (got < 0) {
+                if (errno == EINTR) continue;
+                free(block);
+                block = NULL;
+                break;
+            }
+            size += (size_t)got;
+            if (size == cap) {
+                cap *= 2;
+                char *bigger = (char *)realloc(block, cap);
+                if (bigger == NULL) {
+                    free(block);
+                }
+                block = bigger;
+            }
+        }
+        if (block == NULL) {
+            close(fd);
+            return 0;
+        }
+        buf = block;
+    }
+    close(fd);
+    lexer_init(lx, buf, size, dialect);
+    lx->in_mapped = mapped;
+    lx->in_owned = 1;
+    return 1;
+}
+
+const char *lexer_build(void) {
+    return __DATE__ " " __TIME__;
+}
+
+#ifdef COLLECT_STATS
+long long lexer_nanos(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+#endif
+
+//lexer_init() points a lexer at a buffer and reads the first character. The buffer stays the caller's and must live as long as the lexer.
+void lexer_init(Lexer *lx, const char *buffer, size_t size, int dialect) {
+//The run scanners are picked once per process; a function-local static makes that safe when lexers start on several threads.
+    static int scannersReady = (selectRunScanners(), 1);
+    (void)scannersReady;
+    lx->dialect = dialect;
+    lx->in_buf = buffer;
+    lx->in_ptr = buffer;
+    lx->in_end = buffer + size;
+    lx->in_size = size;
+    lx->in_mapped = 0;
+    lx->in_owned = 0;
+    lx->lexLen = 0;
+    lx->dropped = 0;
+    lx->tokenStart = 0;
+    lx->lexeme[0] = '\0';
+    lx->nextToken = END_OF_FILE;
+#ifdef COLLECT_STATS
+    lx->keywordLookups = 0;
+    lx->keywordNanos = 0;
+#endif
+    getChar(lx);
+}
+
+//lexer_close() unmaps or frees the input buffer depending on how lexer_open() got it; a buffer given to lexer_init() is left alone.
+void lexer_close(Lexer *lx) {
+    if (lx->in_mapped) {
+        munmap((void *)lx->in_buf, lx->in_size);
+    } else if (lx->in_owned) {
+        free((void *)lx->in_buf);
+    }
+    lx->in_buf = lx->in_ptr = lx->in_end = NULL;
+    lx->in_mapped = lx->in_owned = 0;
+}
+
+/*****************************************************/
+/* 
+Run scanners 
+*/
+
+/*
+A run scanner returns the first position in [p, end) whose character is not part of the run.
+The plain C version checks one character at a time with the class table; it is also used for the tail of the vector versions.
+*/
+typedef const char *(*RunScanner)(const char *p, const char *end);
+
+static RunScanner scanRun[NUM_RUN_KINDS];
+
+//The runs are the same in both dialects (an identifier run stops at '_', which the DFA then adds), so the C table is used for them.
+template <int kind>
+static const char *scalarRun(const char *p, const char *end) {
+    while (p < end) {
+        int cls = charClassTables[LEX_C].cls[(unsigned char)*p];
+        if (kind == BLANK_RUN ? cls != BLANK : kind == DIGIT_RUN ? cls != DIGIT : cls > DIGIT) {
+            break;
+        }
+        p++;
+    }
+    return p;
+}
+
+#ifdef HAVE_X86_SIMD
+/*
+The SSE2 version checks 16 characters at a time. sse2InRange() marks bytes in [lo, lo + count) using one unsigned compare,
+and sse2RunMask() combines those ranges into the set for each run kind (letters are folded to lower case with | 0x20).
+*/
+__attribute__((target("sse2")))
+static inline __m128i sse2InRange(__m128i v, char lo, char count) {
+    __m128i d = _mm_sub_epi8(v, _mm_set1_epi8(lo));
+    return _mm_cmpeq_epi8(_mm_min_epu8(d, _mm_set1_epi8(count - 1)), d);
+}
+
+template <int kind>
+__attribute__((target("sse2")))
+static inline __m128i sse2RunMask(__m128i v) {
+    if (kind == BLANK_RUN) {
+        return _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), sse2InRange(v, '\t', 5));
+    }
+    __m128i digits = sse2InRange(v, '0', 10);
+    if (kind == DIGIT_RUN) {
+        return digits;
+    }
+    return _mm_or_si128(digits, sse2InRange(_mm_or_si128(v, _mm_set1_epi8(0x20)), 'a', 26));
+}
+
+template <int kind>
+__attribute__((target("sse2")))
+static const char *sse2Run(const char *p, const char *end) {
+    while (end - p >= 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)p);
+        unsigned outside = ~(unsigned)_mm_movemask_epi8(sse2RunMask<kind>(v)) & 0xFFFFu;
+        if (outside != 0) {
+            return p + __builtin_ctz(outside);
+        }
+        p += 16;
+    }
+    return scalarRun<kind>(p, end);
+}
+
+//The AVX2 version is the same idea, 32 characters at a time.
+__attribute__((target("avx2")))
+static inline __m256i avx2InRange(__m256i v, char lo, char count) {
+    __m256i d = _mm256_sub_epi8(v, _mm256_set1_epi8(lo));
+    return _mm256_cmpeq_epi8(_mm256_min_epu8(d, _mm256_set1_epi8(count - 1)), d);
+}
+
+template <int kind>
+__attribute__((target("avx2")))
+static inline __m256i avx2RunMask(__m256i v) {
+    if (kind == BLANK_RUN) {
+        return _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')), avx2InRange(v, '\t', 5));
+    }
+    __m256i digits = avx2InRange(v, '0', 10);
+    if (kind == DIGIT_RUN) {
+        return digits;
+    }
+    return _mm256_or_si256(digits, avx2InRange(_mm256_or_si256(v, _mm256_set1_epi8(0x20)), 'a', 26));
+}
+
+template <int kind>
+__attribute__((target("avx2")))
+static const char *avx2Run(const char *p, const char *end) {
+    while (end - p >= 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)p);
+        unsigned outside = ~(unsigned)_mm256_movemask_epi8(avx2RunMask<kind>(v));
+        if (outside != 0) {
+            return p + __builtin_ctz(outside);
+        }
+        p += 32;
+    }
+    return sse2Run<kind>(p, end);
+}
+#endif
+
+//Run scanner versions, from the plain C one to the widest.
+#define SCAN_SCALAR       0
+#define SCAN_SSE2         1
+#define SCAN_AVX2         2
+#define NUM_SCAN_VERSIONS 3
+
+//useRunScanners() fills scanRun[] with one version, and returns 0 (leaving scanRun[] alone) if this build or CPU doesn't have it.
+static int useRunScanners(int version) {
+    scanRun[NO_RUN] = NULL;
+    if (version == SCAN_SCALAR) {
+        scanRun[IDENT_RUN] = scalarRun<IDENT_RUN>;
+        scanRun[DIGIT_RUN] = scalarRun<DIGIT_RUN>;
+        scanRun[BLANK_RUN] = scalarRun<BLANK_RUN>;
+        return 1;
+    }
+#ifdef HAVE_X86_SIMD
+    __builtin_cpu_init();
+    if (version == SCAN_AVX2 && __builtin_cpu_supports("avx2")) {
+        scanRun[IDENT_RUN] = avx2Run<IDENT_RUN>;
+        scanRun[DIGIT_RUN] = avx2Run<DIGIT_RUN>;
+        scanRun[BLANK_RUN] = avx2Run<BLANK_RUN>;
+        return 1;
+    }
+    if (version == SCAN_SSE2 && __builtin_cpu_supports("sse2")) {
+        scanRun[IDENT_RUN] = sse2Run<IDENT_RUN>;
+        scanRun[DIGIT_RUN] = sse2Run<DIGIT_RUN>;
+        scanRun[BLANK_RUN] = sse2Run<BLANK_RUN>;
+        return 1;
+    }
+#endif
+    return 0;
+}
+
+/*
+selectRunScanners() fills scanRun[] with the best version the CPU supports. Setting LEXER_SIMD to scalar, sse2 or avx2
+forces a particular version, which is how the vector scanners are checked against the plain C one.
+*/
+static void selectRunScanners() {
+    const char *want = getenv("LEXER_SIMD");
+    useRunScanners(SCAN_SCALAR);
+    if (want != NULL && strcmp(want, "scalar") == 0) {
+        return;
+    }
+    if ((want == NULL || strcmp(want, "avx2") == 0) && useRunScanners(SCAN_AVX2)) {
+        return;
+    }
+    useRunScanners(SCAN_SSE2);
+}
+
+/*****************************************************/
+/* 
+Keyword table 
+*/
+
+/*
+keywordList holds every reserved word the lexer recognizes. To recognize more of C (return, struct, void, char, case, break, ...),
+just add the word here; the hash table below is rebuilt at compile time and stays collision free.
+*/
+constexpr const char *keywordList[] = {
+//These are type related keywords like int, short, or long, and the numeric type keywords that tell how numbers should be stored.
+    "int", "short", "long", "signed", "unsigned", "float",
+//These are more reserved words used in C like double, const, and do.
+    "double", "const", "do",
+//These are the control flow keywords.
+    "else", "for", "if", "switch", "while"
+};
+
+#define NUM_KEYWORDS       (int)(sizeof(keywordList) / sizeof(keywordList[0]))
+#define KEYWORD_TABLE_SIZE 64   // power of two, larger than NUM_KEYWORDS
+
+//constexpr helpers to get a word's length and compare two words while the table is built at compile time.
+constexpr int constLength(const char *s) {
+    int n = 0;
+    while (s[n] != '\0') n++;
+    return n;
+}
+
+/*
+keywordHash() only looks at the first character, the last character and the length, so hashing an identifier costs
+the same no matter how long it is. mulFirst and mulLast are picked by buildKeywordTable() so no two keywords share a slot.
+*/
+constexpr unsigned keywordHash(const char *word, int len, unsigned mulFirst, unsigned mulLast) {
+    return ((unsigned char)word[0] * mulFirst + (unsigned char)word[len - 1] * mulLast + (unsigned)len)
+           & (KEYWORD_TABLE_SIZE - 1);
+}
+
+//KeywordTable is the perfect hash table: each slot holds at most one keyword, plus the multipliers that make the hash collision free.
+struct KeywordTable {
+    const char *word[KEYWORD_TABLE_SIZE];
+    int len[KEYWORD_TABLE_SIZE];
+    unsigned mulFirst;
+    unsigned mulLast;
+    int minLen;
+    int maxLen;
+};
+
+//buildKeywordTable() tries multiplier pairs until every keyword lands in its own slot, then fills the table.
+constexpr KeywordTable buildKeywordTable() {
+    KeywordTable t = {};
+    for (unsigned a = 1; a < 256; a++) {
+        for (unsigned b = 1; b < 256; b++) {
+            bool used[KEYWORD_TABLE_SIZE] = {};
+            bool ok = true;
+            for (int k = 0; k < NUM_KEYWORDS && ok; k++) {
+                unsigned h = keywordHash(keywordList[k], constLength(keywordList[k]), a, b);
+                ok = !used[h];
+                used[h] = true;
+            }
+            if (ok) {
+                t.mulFirst = a;
+                t.mulLast = b;
+                t.minLen = KEYWORD_TABLE_SIZE;
+                for (int k = 0; k < NUM_KEYWORDS; k++) {
+                    int len = constLength(keywordList[k]);
+                    unsigned h = keywordHash(keywordList[k], len, a, b);
+                    t.word[h] = keywordList[k];
+                    t.len[h] = len;
+                    if (len < t.minLen) t.minLen = len;
+                    if (len > t.maxLen) t.maxLen = len;
+                }
+                return t;
+            }
+        }
+    }
+    return t;
+}
+
+constexpr KeywordTable keywordTable = buildKeywordTable();
+static_assert(keywordTable.mulFirst != 0, "no collision-free keyword hash found; grow KEYWORD_TABLE_SIZE");
+
+/*
+checkKeyword() ensures accurate token classification by checking if a lexeme is a keyword.
+It hashes the word once and compares it against the single keyword in that slot, if there is one.
+*/
+static TokenType checkKeyword(const char *word, int len) {
+    if (len < keywordTable.minLen || len > keywordTable.maxLen) {
+        return IDENT;
+    }
+    unsigned h = keywordHash(word, len, keywordTable.mulFirst, keywordTable.mulLast);
+    if (keywordTable.len[h] == len && memcmp(word, keywordTable.word[h], len) == 0) {
+        return KEYWORD;
+    }
+    return IDENT;
+}
+
+
+/*****************************************************/
+/* 
+Lexical analyzer functions 
+*/
+
+//runDfa() walks the scanner table: while the current character has a transition out of the current state, add it to the lexeme and move on.
+static int runDfa(Lexer *lx, int state) {
+    const DfaTable &dfa = dfaTables[lx->dialect];
+    int next;
+    while ((next = dfa.next[state][lx->charClass]) != S_START) {
+        state = next;
+//States that loop on a run (identifier characters or digits) take the whole run in one go.
+        if (dfa.selfRun[state] != NO_RUN) {
+            addRun(lx, dfa.selfRun[state]);
+        } else {
+            addChar(lx);
+            getChar(lx);
+        }
+    }
+//Returns the state the scanner stopped in, so lex() can look up which token it has found.
+    return state;
+}
+
+/*
+We need addChar() to safely add each valid character to the current token lexeme and make sure it forms a proper string for processing.
+A character that doesn't fit is counted in dropped so the caller can report it.
+*/
+static void addChar(Lexer *lx) {
+    if (lx->lexLen <= 98) {
+        lx->lexeme[lx->lexLen++] = lx->nextChar;
+        lx->lexeme[lx->lexLen] = '\0';
+    } else {
+        lx->dropped++;
+    }
+}
+
+/*
+addRun() adds the current character plus the rest of its run to the lexeme with one copy, then reads the character after the run.
+Characters past the lexeme limit are counted in dropped, exactly as addChar() would.
+*/
+static void addRun(Lexer *lx, int kind) {
+    const char *runEnd = scanRun[kind](lx->in_ptr, lx->in_end);
+    addChar(lx);
+    size_t n = (size_t)(runEnd - lx->in_ptr);
+    size_t room = (size_t)(99 - lx->lexLen);
+    size_t fit = n < room ? n : room;
+    memcpy(lx->lexeme + lx->lexLen, lx->in_ptr, fit);
+    lx->lexLen += (int)fit;
+    lx->lexeme[lx->lexLen] = '\0';
+    lx->dropped += (int)(n - fit);
+    lx->in_ptr = runEnd;
+    getChar(lx);
+}
+
+//The getChar() function is responsible for reading the next character from the input buffer and classifying it into one of the defined character classes
+static void getChar(Lexer *lx) {
+//Takes the next character from the buffer and looks its class up in the table.
+    if (lx->in_ptr < lx->in_end) {
+        lx->nextChar = *lx->in_ptr++;
+        lx->charClass = charClassTables[lx->dialect].cls[(unsigned char)lx->nextChar];
+// A 0xFF byte classifies as END_CHAR; make it look exactly like the end of the input.
+        if (lx->charClass == END_CHAR) {
+            lx->nextChar = EOF;
+        }
+    } else {
+// If nothing left to read, mark it as end of file
+        lx->nextChar = EOF; 
+        lx->charClass = END_CHAR;
+    }
+}
+
+//This function getNonBlank() to skip over spaces, tabs, and newlines so the lexical analyzer only looks at real code, not empty space.
+static void getNonBlank(Lexer *lx) {
+    while (lx->charClass == BLANK) {
+        lx->in_ptr = scanRun[BLANK_RUN](lx->in_ptr, lx->in_end);
+        getChar(lx);
+    }
+}
+
+/*
+This starts the lex() function to reset the lexeme length and skip any whitespace before starting to build the next token.
+*/
+static TokenType lex(Lexer *lx) {
+    lx->lexLen = 0;
+    lx->dropped = 0;
+    getNonBlank(lx);
+
+/*
+This part checks if we reached the end of the file.
+If so, we stop analyzing and mark it with a special EOF token so the parser knows there’s no more input to read.
+*/
+
+    if (lx->charClass == END_CHAR) {
+        lx->nextToken = END_OF_FILE;
+        lx->tokenStart = (size_t)(lx->in_ptr - lx->in_buf);
+        strcpy(lx->lexeme, "EOF");
+        lx->lexLen = 3;
+        return lx->nextToken;
+    }
+
+    //The current character has already been read, so the token starts one position before in_ptr.
+    lx->tokenStart = (size_t)(lx->in_ptr - 1 - lx->in_buf);
+
+    // Run the scanner table from the start state; the state it stops in tells us which token we built.
+    lx->nextToken = dfaTables[lx->dialect].accept[runDfa(lx, S_START)];
+
+    //After an identifier is built, this checks if it's a keyword or just a regular variable name and assigns the right token code.
+    //The expression language has no keywords, so there every identifier stays an identifier (a variable may be called int or while).
+    if (lx->nextToken == IDENT && lx->dialect != LEX_EXPR) {
+#ifdef COLLECT_STATS
+        long long start = lexer_nanos();
+        lx->nextToken = checkKeyword(lx->lexeme, lx->lexLen);
+        lx->keywordNanos += lexer_nanos() - start;
+        lx->keywordLookups++;
+#else
+        lx->nextToken = checkKeyword(lx->lexeme, lx->lexLen);
+#endif
+    }
+    //To check if an identifier is immediately followed by a valid array index in square brackets
+    if (lx->nextToken == IDENT && lx->charClass == LBRACKET_CHAR) {
+        addChar(lx); getChar(lx);
+        lx->nextToken = dfaTables[lx->dialect].accept[runDfa(lx, S_ARRAY_OPEN)];
+    }
+
+    //Return nextToken at the end of the lex() function to send the identified token code back to the parser
+    return lx->nextToken;
+}
+
+/*
+lexer_next() scans one token and fills in tok. The token covers every character that was added to the lexeme or dropped from it;
+the end-of-file token has size 0.
+*/
+TokenType lexer_next(Lexer *lx, LexToken *tok) {
+    TokenType code = lex(lx);
+    tok->code = code;
+    tok->lexeme = lx->lexeme;
+    tok->length = lx->lexLen;
+    tok->offset = lx->tokenStart;
+    tok->size = code == END_OF_FILE ? 0 : (size_t)(lx->lexLen + lx->dropped);
+    tok->dropped = lx->dropped;
+    return code;
+}
+
+/*****************************************************/
+/* 
+Self-test 
+*/
+
+/*
+The self-test fills buffers with random runs of letters, digits, '_', blanks and operator characters, plus single random bytes
+(0xFF and bytes above 127 included), placed at random offsets so the vector loads are unaligned and the runs end in the tail too.
+selfTestRandom() is xorshift32, so a seed always gives the same buffers.
+*/
+#define SELF_TEST_AREA    512
+#define SELF_TEST_MAX     400
+
+static unsigned selfTestRandom(unsigned *state) {
+    unsigned x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static void selfTestFill(char *buf, size_t size, unsigned *state) {
+    static const char *const runChars[] = {
+        "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_", "0123456789", " \t\n\v\f\r", "+-*/=()<>!&|.[]%^~{},;"
+    };
+    size_t i = 0;
+    while (i < size) {
+        unsigned kind = selfTestRandom(state) % 5;
+        size_t run = 1 + selfTestRandom(state) % 70;
+        for (size_t k = 0; k < run && i < size; k++) {
+            if (kind == 4) {
+                buf[i++] = (char)(selfTestRandom(state) & 0xFF);
+            } else {
+                const char *chars = runChars[kind];
+                buf[i++] = chars[selfTestRandom(state) % strlen(chars)];
+            }
+        }
+    }
+}
+
+//SelfTestToken is one token as the plain C scanners produced it, kept to compare the other versions against.
+struct SelfTestToken {
+    TokenType code;
+    int length;
+    size_t offset;
+    size_t size;
+    int dropped;
+    char lexeme[100];
+};
+
+//selfTestScan() lexes the buffer in one dialect into tokens (the end-of-file token included) and returns how many there were.
+static int selfTestScan(const char *buf, size_t size, int dialect, SelfTestToken *tokens) {
+    Lexer lx;
+    LexToken tok;
+    lexer_init(&lx, buf, size, dialect);
+    int n = 0;
+    do {
+        lexer_next(&lx, &tok);
+        tokens[n].code = tok.code;
+        tokens[n].length = tok.length;
+        tokens[n].offset = tok.offset;
+        tokens[n].size = tok.size;
+        tokens[n].dropped = tok.dropped;
+        memcpy(tokens[n].lexeme, tok.lexeme, (size_t)tok.length + 1);
+        n++;
+    } while (tok.code != END_OF_FILE);
+    return n;
+}
+
+/*
+lexer_self_test() runs every buffer through the plain C scanners first: where each run kind ends from every starting position, and the
+tokens of both dialects. Then, for each vector version this CPU has, it does the same and counts every difference. At the end the
+version chosen at start-up (or by LEXER_SIMD) is put back.
+*/
+int lexer_self_test(unsigned seed, int buffers, int *versions) {
+    static char area[SELF_TEST_AREA];
+    static SelfTestToken expected[LEX_DIALECTS][SELF_TEST_MAX + 1];
+    static SelfTestToken found[SELF_TEST_MAX + 1];
+    static const char *runEnds[NUM_RUN_KINDS][SELF_TEST_MAX + 1];
+    int expectedCount[LEX_DIALECTS];
+    unsigned state = seed != 0 ? seed : 1;
+    int mismatches = 0;
+//Lexing once makes sure the start-up choice has been made, so restoring it at the end can't be undone by a later first lexer_init().
+    Lexer first;
+    lexer_init(&first, "", 0, LEX_C);
+    *versions = 1;
+    for (int version = SCAN_SSE2; version < NUM_SCAN_VERSIONS; version++) {
+        if (useRunScanners(version)) (*versions)++;
+    }
+    for (int b = 0; b < buffers; b++) {
+        size_t size = selfTestRandom(&state) % (SELF_TEST_MAX + 1);
+        char *buf = area + selfTestRandom(&state) % (SELF_TEST_AREA - SELF_TEST_MAX);
+        selfTestFill(buf, size, &state);
+        useRunScanners(SCAN_SCALAR);
+        for (int kind = IDENT_RUN; kind < NUM_RUN_KINDS; kind++) {
+            for (size_t i = 0; i <= size; i++) runEnds[kind][i] = scanRun[kind](buf + i, buf + size);
+        }
+        for (int d = 0; d < LEX_DIALECTS; d++) expectedCount[d] = selfTestScan(buf, size, d, expected[d]);
+        for (int version = SCAN_SSE2; version < NUM_SCAN_VERSIONS; version++) {
+            if (!useRunScanners(version)) continue;
+            for (int kind = IDENT_RUN; kind < NUM_RUN_KINDS; kind++) {
+                for (size_t i = 0; i <= size; i++) {
+                    if (scanRun[kind](buf + i, buf + size) != runEnds[kind][i]) mismatches++;
+                }
+            }
+            for (int d = 0; d < LEX_DIALECTS; d++) {
+                int n = selfTestScan(buf, size, d, found);
+                if (n != expectedCount[d]) {
+                    mismatches++;
+                    continue;
+                }
+                for (int t = 0; t < n; t++) {
+                    const SelfTestToken &e = expected[d][t];
+                    const SelfTestToken &f = found[t];
+                    if (e.code != f.code || e.length != f.length || e.offset != f.offset || e.size != f.size ||
+                        e.dropped != f.dropped || strcmp(e.lexeme, f.lexeme) != 0) {
+                        mismatches++;
+                    }
+                }
+            }
+        }
+    }
+    selectRunScanners();
+    return mismatches;
+}
@@ -0,0 +1,117 @@
+// Yutong Ye 12012842
+
+/*
+Lexer.h is the token library shared by the lexical analyzer and the syntax analyzer. Both programs are built together with Lexer.cpp:
+
+    g++ -O2 "lexical analyzer.cpp" Lexer.cpp -o lexer
+    g++ -O2 -pthread SyntaxAnalyzer.cpp Lexer.cpp -o analyzer
+
+so the character table, the scanner table (DFA) and the SSE2/AVX2 run scanners exist once, and a speed-up in one of them helps both.
+*/
+#ifndef LEXER_H
+#define LEXER_H
+
+#include <stddef.h>
+
+/*
+TokenType is the one list of tokens for both programs. The first group is the expression language of the syntax analyzer, in the order
+its binary output has always used; the second group are the other C tokens, which the syntax analyzer only names in its errors. Each
+program prints its own numbers for them (the lexical analyzer its classic codes like 11 for an identifier, the syntax analyzer the type
+plus 10), so their output has not changed.
+*/
+enum TokenType {
+//Operands, the operators of the expression language, parentheses and the end of the input.
+    IDENT, INT_LIT, ASSIGN_OP, ADD_OP, SUB_OP, MULT_OP, DIV_OP,
+    UNARY_MINUS, BNOT_OP, REQ_OP, RNEQ_OP, RLT_OP, RLEQ_OP, RGT_OP, RGEQ_OP,
+    BAND_OP, BOR_OP, LEFT_PAREN, RIGHT_PAREN, END_OF_FILE,
+//Constants, names and separators outside the expression language.
+    FLOAT_LIT, ARRAY_ID, KEYWORD, LEFT_BRACE, RIGHT_BRACE, COMMA, SEMICOLON,
+//The other C operators: power, modulo, increment and decrement, and the compound assignments.
+    POW_OP, MOD_OP, INC_OP, DEC_OP,
+    ADD_ASSIGN_OP, SUB_ASSIGN_OP, MULT_ASSIGN_OP, DIV_ASSIGN_OP, POW_ASSIGN_OP, MOD_ASSIGN_OP,
+//UNKNOWN is any character sequence that isn't a valid token in the dialect being scanned.
+    UNKNOWN,
+    TOKEN_TYPE_COUNT
+};
+
+/*
+A dialect picks which tokens are recognized. LEX_C is the lexical analyzer's C subset (floats, array identifiers, keywords, ++, +=, ...).
+LEX_EXPR is the syntax analyzer's expression language: identifiers may contain '_', and ==, !=, <, <=, >, >=, &&, || and ! are
+operators. It has no keywords: int, while and the rest are ordinary identifiers there. It also returns the C tokens the parser can name
+(floats, array identifiers, % and ^, the compound assignments, braces and commas), but not ++, --, ~ or ;. Anything else (a single '&'
+or '|' too) is UNKNOWN.
+*/
+#define LEX_C             0
+#define LEX_EXPR          1
+#define LEX_DIALECTS      2
+
+/*
+A Lexer carries everything one scan needs, so several lexers can run at the same time (one per file or per thread) without sharing anything.
+*/
+struct Lexer {
+//These store the dialect, the current character, its type, and build the token string.
+    int dialect;
+    int charClass;
+    char lexeme[100];
+    char nextChar;
+//These track the token length, the characters that didn't fit into lexeme, where the token started in the input, and the current token.
+    int lexLen;
+    int dropped;
+    size_t tokenStart;
+    TokenType nextToken;
+//These describe the input buffer: where it starts, where the scanner is now, and where it ends, so getChar() walks memory instead of calling getc().
+    const char *in_buf;
+    const char *in_ptr;
+    const char *in_end;
+//These remember how the buffer was obtained (mapped, read in blocks, or handed in by the caller) so lexer_close() can release it the right way.
+    size_t in_size;
+    int in_mapped;
+    int in_owned;
+//A build with -DCOLLECT_STATS (every file of the program built with it) also counts the keyword lookups and the nanoseconds they took.
+#ifdef COLLECT_STATS
+    long long keywordLookups;
+    long long keywordNanos;
+#endif
+};
+
+/*
+A LexToken is what lexer_next() hands back: the token type, its lexeme (at most 99 characters, valid until the next call),
+and where the token sits in the input (offset and size), so a parser can take the full text straight from the buffer.
+dropped counts the characters that were too many for the lexeme.
+*/
+struct LexToken {
+    TokenType code;
+    const char *lexeme;
+    int length;
+    size_t offset;
+    size_t size;
+    int dropped;
+};
+
+/*
+lexer_open() loads a whole file into memory (mmap when possible, large block reads otherwise) and lexer_init() scans a buffer the caller
+already has; both take the dialect to scan. lexer_next() returns the next token, and lexer_close() releases the input.
+*/
+int lexer_open(Lexer *lx, const char *path, int dialect);
+void lexer_init(Lexer *lx, const char *buffer, size_t size, int dialect);
+TokenType lexer_next(Lexer *lx, LexToken *tok);
+void lexer_close(Lexer *lx);
+
+/*
+lexer_build() names the build of Lexer.cpp (its compile date and time), so a cache of lexer results can tell when the lexer has changed.
+*/
+const char *lexer_build(void);
+
+/*
+lexer_self_test() checks the SSE2 and AVX2 run scanners against the plain C ones on random buffers made from seed: where every run ends,
+and every token of both dialects. It returns the number of differences and sets *versions to how many scanner versions were compared.
+It switches the scanners of the whole process while it runs, so no other lexer may be scanning at the same time.
+*/
+int lexer_self_test(unsigned seed, int buffers, int *versions);
+
+#ifdef COLLECT_STATS
+//lexer_nanos() reads a monotonic clock in nanoseconds, for timing the phases of a scan.
+long long lexer_nanos(void);
+#endif
+
+#endif
@@ -1,391 +1,3410 @@
 //These headers enable reading input files, printing output, storing tokens and expressions, and evaluating postfix notation using a stack.
 #include <iostream>
 #include <fstream>
-#include <sstream>
 #include <vector>
-#include <stack>
-//These headers support parsing by enabling character checks, string handling, formatted output, and mapping token types to readable names for lexical analysis.
-#include <map>
+//These headers support parsing by enabling character checks, string handling and formatted output for lexical analysis.
 #include <cctype>
 #include <string>
 #include <cstdio>
+//These headers provide malloc/free and size_t for the arena that holds the expression tree.
+#include <cstdlib>
+#include <cstddef>
+//This header provides memcpy for moving columns in and out of the --columnar register file.
+#include <cstring>
+//These headers provide the worker threads, locks and queues used when statements are processed in parallel with --jobs.
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+//This header times the --eval benchmark.
+#include <chrono>
+//These headers keep the index of compiled functions and load the libraries made by --emit-cpp.
+#include <map>
+#include <set>
+#include <dlfcn.h>
+//These headers hold the --expr-cache LRU list and its index, and map its file into memory.
+#include <list>
+#include <unordered_map>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+//This header waits for the compiler that --emit-cpp runs.
+#include <sys/wait.h>
+//This header is the token library shared with the lexical analyzer: the TokenType list and the table-driven scanner (build with Lexer.cpp).
+#include "Lexer.h"
 
 using namespace std;
 
-//This enum defines all possible token types used by the lexical analyzer to classify parts of the input, like identifiers, operators, and parentheses.
-enum TokenType {
-    IDENT, INT_CONST, ASSIGN_OP, ADD_OP, SUB_OP, MULT_OP, DIV_OP,
-    UNARY_MINUS, BNOT_OP, REQ_OP, RNEQ_OP, RLT_OP, RLEQ_OP, RGT_OP, RGEQ_OP,
-    BAND_OP, BOR_OP, LEFT_PAREN, RIGHT_PAREN, END_OF_FILE
-};
+//TEMP_REF is never a token: with --cse it marks a postfix item that reuses a temporary computed earlier. It comes right after the last TokenType.
+const TokenType TEMP_REF = (TokenType)TOKEN_TYPE_COUNT;
 
-//This struct Token stores the type and actual text lexeme of each token found during lexical analysis, allowing the parser to understand and process input code.
+//This struct Token stores the type of each token and where its lexeme sits in the source line (offset and length), so tokens are small plain records that never copy or allocate text.
 struct Token {
     TokenType type;
-    string lexeme;
+    unsigned offset;
+    unsigned length;
 
     Token() {}
-    Token(TokenType t, const string& l) : type(t), lexeme(l) {}
+    Token(TokenType t, unsigned o, unsigned l) : type(t), offset(o), length(l) {}
+};
+
+/*
+An Arena hands out memory for tree nodes by bumping a pointer through large blocks, so building a tree costs no new/delete per node.
+reset() throws away everything allocated so far in one step (the blocks are kept and reused), and the counters show how the arena is sized.
+*/
+struct ArenaBlock {
+    ArenaBlock* next;
+    size_t size;
+};
+
+struct Arena {
+    size_t blockSize;
+    ArenaBlock* first;
+    ArenaBlock* current;
+    size_t used;
+//These are the usage counters: bytes handed out since the last reset, the most ever handed out between two resets, bytes reserved from malloc, blocks, allocations and resets.
+    size_t bytesUsed;
+    size_t peakBytes;
+    size_t bytesReserved;
+    size_t blockCount;
+    size_t allocations;
+    size_t resets;
+
+    Arena(size_t blockBytes) : blockSize(blockBytes), first(NULL), current(NULL), used(0), bytesUsed(0), peakBytes(0),
+                               bytesReserved(0), blockCount(0), allocations(0), resets(0) {}
+    ~Arena() { release(); }
+
+//allocate() returns size bytes aligned for any node type, moving on to the next block (or a new one) when the current block is full.
+    void* allocate(size_t size) {
+        size = (size + alignof(max_align_t) - 1) & ~(alignof(max_align_t) - 1);
+        while (current == NULL || used + size > current->size) {
+            if (current != NULL && current->next != NULL) {
+                current = current->next;
+            } else {
+                size_t bytes = size > blockSize ? size : blockSize;
+                ArenaBlock* block = (ArenaBlock*)malloc(sizeof(ArenaBlock) + bytes);
+                if (block == NULL) {
+                    cerr << "Error: out of memory for expression tree" << endl;
+                    exit(1);
+                }
+                block->next = NULL;
+                block->size = bytes;
+                if (current == NULL) first = block; else current->next = block;
+                bytesReserved += bytes;
+                blockCount++;
+                current = block;
+            }
+            used = 0;
+        }
+        void* p = (char*)(current + 1) + used;
+        used += size;
+        bytesUsed += size;
+        if (bytesUsed > peakBytes) peakBytes = bytesUsed;
+        allocations++;
+        return p;
+    }
+
+//reset() frees every node at once by starting over at the first block.
+    void reset() {
+        current = first;
+        used = 0;
+        bytesUsed = 0;
+        resets++;
+    }
+
+//release() gives all blocks back to the system.
+    void release() {
+        while (first != NULL) {
+            ArenaBlock* next = first->next;
+            free(first);
+            first = next;
+        }
+        current = NULL;
+        used = 0;
+        bytesUsed = 0;
+    }
+};
+
+/*
+Node is one node of the expression tree built by the parser. Leaves are IDENT or INT_LIT operands; every other node is an operator
+with one child (UNARY_MINUS, BNOT_OP) or two, and the root of a statement is an ASSIGN_OP whose left child is the variable.
+The token is kept so later stages can still print the original lexeme.
+*/
+struct Node {
+    TokenType op;
+    Token token;
+    Node* left;
+    Node* right;
+//Constants made by the fold pass have no text in the source line; they keep their value and symbol id here (operand is NO_OPERAND otherwise).
+    long long value;
+    int operand;
+//With --cse, temp is the temporary that holds the node's value once its instruction has been emitted (-1 before that), and symbol is
+//the symbol id of an operand, kept because in a block the source line it came from is gone by the time a later statement uses it.
+    int temp;
+    int symbol;
+//mayTrap is set by the fold pass on a node whose value needs a division by something that isn't a known non-zero constant.
+    bool mayTrap;
+};
+
+/*
+StackFrame is one open grammar rule of the explicit-stack parser: which rule it is, how far into it the parser is, and the index of the
+operator token it took last. The trees built so far are kept on a separate stack, so a frame is only 8 bytes.
+*/
+struct StackFrame {
+    int opIndex;
+    unsigned char rule;
+    unsigned char state;
+};
+
+/*
+TreeFrame is one entry of the explicit stack the tree passes (--fold, --cse) walk with, so a deep tree (a long chain of operators, or
+many nested unary operators) can't overflow the thread's stack. Only operations get a frame: link is where the new node for node goes,
+and expanded is set once the walk has gone on to the right child.
+*/
+struct TreeFrame {
+    Node* node;
+    Node** link;
+    bool expanded;
+};
+
+/*
+SymbolTable interns the names of variables and constants: every distinct name is stored once and gets a small integer id, so the
+intermediate code can refer to operands by number. Lookups hash the characters straight from the source line (an open-addressing
+table of ids), so no string is built unless the name is new.
+*/
+struct SymbolTable {
+    vector<string> names;
+    vector<int> slots;
+
+    SymbolTable() : slots(64, -1) {}
+
+    static unsigned hash(const char* s, size_t n) {
+        unsigned h = 2166136261u;
+        for (size_t i = 0; i < n; ++i) {
+            h = (h ^ (unsigned char)s[i]) * 16777619u;
+        }
+        return h;
+    }
+
+    int intern(const char* s, size_t n) {
+        size_t mask = slots.size() - 1;
+        size_t i = hash(s, n) & mask;
+        while (slots[i] != -1) {
+            const string& name = names[slots[i]];
+            if (name.size() == n && name.compare(0, n, s, n) == 0) return slots[i];
+            i = (i + 1) & mask;
+        }
+        slots[i] = (int)names.size();
+        names.push_back(string(s, n));
+        if (names.size() * 2 > slots.size()) grow();
+        return (int)names.size() - 1;
+    }
+
+//clear() forgets every symbol and goes back to the starting size.
+    void clear() {
+        names.clear();
+        slots.assign(64, -1);
+    }
+
+//grow() doubles the table and puts every id back in its new slot.
+    void grow() {
+        slots.assign(slots.size() * 2, -1);
+        size_t mask = slots.size() - 1;
+        for (size_t id = 0; id < names.size(); ++id) {
+            size_t i = hash(names[id].data(), names[id].size()) & mask;
+            while (slots[i] != -1) i = (i + 1) & mask;
+            slots[i] = (int)id;
+        }
+    }
+};
+
+/*
+Quad is one three-address instruction: result = arg1 op arg2. Operands are ids: a value of 0 or more is a symbol from the SymbolTable,
+a negative value is temporary number -(id + 1), and NO_OPERAND marks an unused field. Unary operations leave arg2 unused, and an
+assignment stores the variable in result and the value in arg1.
+*/
+#define NO_OPERAND (-2147483647 - 1)
+
+struct Quad {
+    TokenType op;
+    int arg1;
+    int arg2;
+    int result;
+};
+
+/*
+PostfixItem is one entry of the postfix expression: a typed opcode (a TokenType) and, for IDENT and INT_LIT, the id of the operand in
+the symbol table. Operators have no operand. A minus sign is stored as SUB_OP or UNARY_MINUS depending on where the parser found it, so
+later stages never have to look at the text again.
+*/
+struct PostfixItem {
+    TokenType op;
+    int operand;
+};
+
+/*
+opTable gives every opcode the symbol it is written with and its intermediate code mnemonic. It is indexed by TokenType, so looking up an
+operation is a single array access.
+*/
+struct OpInfo {
+    const char* symbol;
+    const char* mnemonic;
+};
+
+static constexpr OpInfo opTable[] = {
+    {"", ""}, {"", ""}, {"=", "assign"}, {"+", "add"}, {"-", "sub"}, {"*", "mul"}, {"/", "div"}, {"-", "uminus"}, {"!", "bnot"},
+    {"==", "req"}, {"!=", "rneq"}, {"<", "rlt"}, {"<=", "rleq"}, {">", "rgt"}, {">=", "rgeq"}, {"&&", "band"}, {"||", "bor"},
+    {"(", ""}, {")", ""}, {"EOF", ""},
+//The tokens below are C tokens outside the expression language; the parser only names them in errors, so they have no mnemonic.
+    {"", ""}, {"", ""}, {"", ""}, {"{", ""}, {"}", ""}, {",", ""}, {";", ""}, {"^", ""}, {"%", ""}, {"++", ""}, {"--", ""},
+    {"+=", ""}, {"-=", ""}, {"*=", ""}, {"/=", ""}, {"^=", ""}, {"%=", ""}, {"", ""}, {"", ""}
+};
+static_assert(sizeof(opTable) / sizeof(opTable[0]) == TEMP_REF + 1, "opTable needs one entry per TokenType");
+
+int tempOperand(int number) {
+    return -(number + 1);
+}
+
+bool isTemp(int operand) {
+    return operand < 0 && operand != NO_OPERAND;
+}
+
+/*
+tempName() writes the name of temporary number n into buf and returns its length. Temporaries are named A to Z, then AA, AB, ... like
+spreadsheet columns, so any number of them get distinct names.
+*/
+int tempName(int n, char* buf) {
+    char digits[8];
+    int len = 0;
+    for (unsigned v = (unsigned)n + 1; v > 0; v = (v - 1) / 26) {
+        digits[len++] = (char)('A' + (v - 1) % 26);
+    }
+    for (int i = 0; i < len; ++i) {
+        buf[i] = digits[len - 1 - i];
+    }
+    return len;
+}
+
+/*
+The analyzer can write three kinds of output: the full trace (parse tree, postfix and intermediate code, as always), a summary with
+only the totals at the end, or a compact binary stream of token and instruction records. In summary and binary mode the trace text
+is never formatted at all.
+*/
+enum OutputMode {
+    OUTPUT_FULL, OUTPUT_SUMMARY, OUTPUT_BINARY
+};
+
+/*
+OutBuffer collects output in one growing string. operator<< appends text and numbers without the locale and formatting machinery of a
+stream, and the put functions append the fixed-size fields of the binary records. It is only handed to stdout in large pieces.
+*/
+struct OutBuffer {
+    string data;
+
+    OutBuffer& write(const char* s, size_t n) {
+        data.append(s, n);
+        return *this;
+    }
+    void putByte(unsigned char b) {
+        data.push_back((char)b);
+    }
+    void putU32(unsigned v) {
+        data.append((const char*)&v, sizeof(v));
+    }
+//putText() writes a length-prefixed string: a 4-byte length followed by the characters, the same width as the line length of an 'S' record.
+    void putText(const char* s, size_t n) {
+        putU32((unsigned)n);
+        data.append(s, n);
+    }
+    void clear() {
+        data.clear();
+    }
+};
+
+OutBuffer& operator<<(OutBuffer& o, const char* s) {
+    o.data.append(s);
+    return o;
+}
+
+OutBuffer& operator<<(OutBuffer& o, const string& s) {
+    o.data.append(s);
+    return o;
+}
+
+OutBuffer& operator<<(OutBuffer& o, char c) {
+    o.data.push_back(c);
+    return o;
+}
+
+OutBuffer& operator<<(OutBuffer& o, long long v) {
+    char digits[24];
+    int n = 0;
+    unsigned long long u = v < 0 ? 0ULL - (unsigned long long)v : (unsigned long long)v;
+    do {
+        digits[sizeof(digits) - 1 - n++] = (char)('0' + u % 10);
+        u /= 10;
+    } while (u != 0);
+    if (v < 0) digits[sizeof(digits) - 1 - n++] = '-';
+    o.data.append(digits + sizeof(digits) - n, n);
+    return o;
+}
+
+OutBuffer& operator<<(OutBuffer& o, int v) {
+    return o << (long long)v;
+}
+
+/*
+Binary stream layout (machine byte order): the stream starts with "SYNB" and a 4-byte version. Each statement then has
+an 'S' record (4-byte assignment number, 4-byte line length, the line), one 'T' record per token (1-byte TokenType, 4-byte offset
+and 4-byte length in the line) and one 'I' record per instruction (1-byte TokenType of the operation, 1-byte operand count,
+then each operand as a 4-byte length and its characters). Error messages still go to stderr. Version 1 had 2-byte operand lengths,
+which cut names longer than 65535 bytes short.
+*/
+#define BINARY_VERSION 2
+
+//Counters keeps the totals printed by the summary output and by --fold.
+struct Counters {
+    long long statements;
+    long long tokens;
+    long long postfixItems;
+    long long instructions;
+    long long errors;
+    long long folded;
+    long long simplified;
+    long long eliminated;
+    long long shared;
+    long long exprHits;
+    long long exprMisses;
+    long long exprEvictions;
+//These are only kept with --parse-stats: operands parsed, grammar rules entered, the deepest chain of rule calls and the time spent parsing.
+    long long operands;
+    long long ruleCalls;
+    long long maxCallDepth;
+    long long parseNanos;
+};
+
+/*
+Instrumentation (--stats)
+
+A build with -DCOLLECT_STATS times every phase of the analysis and keeps a few more counters in each parser's PhaseStats, and --stats
+dumps them as JSON on stderr at exit. In a normal build PhaseTimer is empty and the counting lines are left out, so it costs nothing.
+*/
+enum Phase {
+    PHASE_READ, PHASE_TOKENIZE, PHASE_PARSE, PHASE_FOLD, PHASE_CSE, PHASE_IC, PHASE_FORMAT, PHASE_WRITE, PHASE_COUNT
+};
+
+static const char* const phaseNames[] = {
+    "read", "tokenize", "parse", "fold", "cse", "generate_ic", "format", "write"
+};
+
+//PhaseStats holds the nanoseconds spent in every phase, the statements and tokens analyzed, the deepest nesting, the temporaries made, the bytes of tree nodes allocated and the bytes written.
+struct PhaseStats {
+    long long nanos[PHASE_COUNT];
+    long long statements;
+    long long tokens;
+    long long maxNesting;
+    long long temps;
+    long long nodeBytes;
+    long long outputBytes;
+};
+
+//PhaseTimer adds the time from its creation to the end of its scope to one phase.
+struct PhaseTimer {
+#ifdef COLLECT_STATS
+    long long* slot;
+    chrono::steady_clock::time_point start;
+
+    PhaseTimer(PhaseStats& stats, Phase phase) : slot(&stats.nanos[phase]), start(chrono::steady_clock::now()) {}
+    ~PhaseTimer() { *slot += chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count(); }
+#else
+    PhaseTimer(PhaseStats&, Phase) {}
+#endif
+};
+
+/*
+--cse picks how far common subexpressions are shared: within each statement, or across the statements of one input line (a basic
+block: "x = a * b; y = a * b + 1"), where a variable that is assigned gets a new version so older expressions using it are not reused.
+*/
+enum CseMode {
+    CSE_OFF, CSE_STATEMENT, CSE_BLOCK
+};
+
+/*
+DagTable is the hash-consing table of the --cse pass. A key is an opcode and two numbers (the canonical children of an operation, or the
+symbol id and version of a leaf), and the value is the one node that stands for it. Slots carry the stamp of the block they belong to,
+so starting a new block is a single increment instead of clearing the table.
+*/
+struct DagSlot {
+    unsigned stamp;
+    TokenType op;
+    long long a;
+    long long b;
+    Node* node;
+};
+
+struct DagTable {
+    vector<DagSlot> slots;
+    unsigned stamp;
+    size_t used;
+
+    DagTable() : slots(256), stamp(1), used(0) {
+        for (size_t i = 0; i < slots.size(); ++i) slots[i].stamp = 0;
+    }
+
+    void clear() {
+        stamp++;
+        used = 0;
+    }
+
+    static size_t hash(TokenType op, long long a, long long b) {
+        unsigned long long h = (unsigned long long)op * 0x9E3779B97F4A7C15ULL;
+        h = (h ^ (unsigned long long)a) * 0xC2B2AE3D27D4EB4FULL;
+        h = (h ^ (unsigned long long)b) * 0x165667B19E3779F9ULL;
+        return (size_t)(h ^ (h >> 29));
+    }
+
+//find() returns the node stored for the key, or stores n for it and returns n.
+    Node* find(TokenType op, long long a, long long b, Node* n) {
+        size_t mask = slots.size() - 1;
+        size_t i = hash(op, a, b) & mask;
+        while (slots[i].stamp == stamp) {
+            if (slots[i].op == op && slots[i].a == a && slots[i].b == b) return slots[i].node;
+            i = (i + 1) & mask;
+        }
+        DagSlot slot = {stamp, op, a, b, n};
+        slots[i] = slot;
+        if (++used * 2 > slots.size()) grow();
+        return n;
+    }
+
+    void grow() {
+        vector<DagSlot> old;
+        old.swap(slots);
+        slots.resize(old.size() * 2);
+        for (size_t i = 0; i < slots.size(); ++i) slots[i].stamp = 0;
+        size_t mask = slots.size() - 1;
+        for (size_t k = 0; k < old.size(); ++k) {
+            if (old[k].stamp != stamp) continue;
+            size_t i = hash(old[k].op, old[k].a, old[k].b) & mask;
+            while (slots[i].stamp == stamp) i = (i + 1) & mask;
+            slots[i] = old[k];
+        }
+    }
+};
+
+/*
+--parser picks how expressions are parsed: the recursive descent parser with one function per precedence level (the default), a Pratt
+(precedence climbing) parser that reads every binary operator's level from a table, so an operand costs two calls instead of seven,
+or the recursive descent parser run on an explicit stack, so nesting is only limited by memory. All of them build the same tree and
+postfix; only the rules in the full trace of the Pratt parser differ.
+*/
+enum ParserKind {
+    PARSER_RECURSIVE, PARSER_PRATT, PARSER_STACK
+};
+
+//Options holds the settings from the command line that every Parser needs, so a worker thread can make its own Parser from them.
+struct Options {
+    size_t arenaBlock;
+    OutputMode mode;
+    bool fold;
+    CseMode cse;
+    size_t exprCacheBytes;
+    ParserKind parser;
+    bool parseStats;
+    int maxNesting;
+};
+
+/*
+--expr-cache keeps the result of every statement it has analyzed, keyed by its token stream (the type of every token and the text of
+names and constants), so a statement that only differs from an earlier one in its spacing is not parsed again. An ExprEntry holds the
+postfix, the intermediate code, the parse trace in full mode and what the --fold and --cse passes counted. The entries are kept in order
+of use, the most recent first, and the oldest are dropped when their estimated size goes over the budget.
+*/
+struct ExprEntry {
+    string key;
+    string trace;
+    vector<PostfixItem> postfix;
+    vector<Quad> ir;
+    long long folded;
+    long long simplified;
+    long long eliminated;
+    long long shared;
+    size_t bytes;
+};
+
+//--expr-cache-file without --expr-cache gets this budget.
+#define DEFAULT_EXPR_CACHE (64 * 1024 * 1024)
+
+struct ExprCache {
+    size_t budget;
+    size_t bytes;
+    list<ExprEntry> entries;
+    unordered_map<string, list<ExprEntry>::iterator> index;
+    string key;
+
+    ExprCache(size_t b) : budget(b), bytes(0) {}
+};
+
+/*
+A Statement is one assignment to analyze. Usually it is a whole input line, but a line may hold several assignments separated by ';'.
+line is the line number in the input file and column is where the statement starts in that line (0 for the first one).
+*/
+struct Statement {
+    string text;
+    int line;
+    int column;
+    bool startsLine;
+};
+
+/*
+A Diagnostic describes one lexical or syntax error: the line and column (counted from 1) where it was found and a readable message.
+outputEnd is how much output had been collected when the failing statement was finished, so a run that stops at the error limit
+writes exactly the output that came before it.
+*/
+struct Diagnostic {
+    int line;
+    int column;
+    string message;
+    size_t outputEnd;
+};
+
+/*
+Parser holds everything one parse needs: the source line the tokens point into, the list of tokens from the input, the current parsing position,
+the syntax rule counter for debugging, how deeply the current factor is nested, how many rule calls are open (callDepth), which expression parser to use and how deep a factor may be nested (0 for no limit),
+the rule and tree stacks of the explicit-stack parser (frames, nodes) and of the tree passes (walk), the postfix expression (as typed opcodes) for intermediate code generation, and the tree of the current statement
+with the arena its nodes come from, the symbol table and the intermediate code (ir, built with the operands stack). The --cse pass
+keeps its hash-consing table in dag, the version of every assigned variable in versions, and the first temporary of the statement in tempBase. exprCache holds the statements already seen for --expr-cache, and stats what --stats reports. All output for the statement goes into out, in the chosen output mode, and an error is described in diagnostic. Each thread owns its own Parser, so statements can be
+processed in parallel without sharing any state.
+*/
+struct Parser {
+    const char* source;
+    vector<Token> tokens;
+    int currentIndex;
+    int ruleId;
+    int depth;
+    int callDepth;
+    ParserKind parser;
+    bool parseStats;
+    int maxNesting;
+    vector<StackFrame> frames;
+    vector<Node*> nodes;
+    vector<TreeFrame> walk;
+    PhaseStats stats;
+    vector<PostfixItem> postfix;
+    Arena arena;
+    Node* ast;
+    SymbolTable symbols;
+    vector<Quad> ir;
+    vector<int> operands;
+    OutputMode mode;
+    bool fold;
+    CseMode cse;
+    DagTable dag;
+    vector<int> versions;
+    int tempBase;
+    int nextTemp;
+    OutBuffer out;
+    vector<size_t> numbers;
+    ExprCache exprCache;
+    Counters counters;
+    Diagnostic diagnostic;
+
+    Parser(const Options& options) : source(""), currentIndex(0), ruleId(1), depth(0), callDepth(0), parser(options.parser),
+                                     parseStats(options.parseStats), maxNesting(options.maxNesting), stats(), arena(options.arenaBlock), ast(NULL),
+                                     mode(options.mode), fold(options.fold), cse(options.cse), tempBase(0), nextTemp(0),
+                                     exprCache(options.exprCacheBytes), counters() {}
+};
+
+//AnalysisError is thrown when a statement can't be tokenized or parsed; offset is where in the statement the problem was found. processStatement() catches it and turns it into a Diagnostic.
+struct AnalysisError {
+    string message;
+    unsigned offset;
+};
+
+//newNode() takes a node from the parser's arena and fills it in.
+Node* newNode(Parser& p, TokenType op, const Token& tok, Node* left, Node* right) {
+    Node* n = (Node*)p.arena.allocate(sizeof(Node));
+#ifdef COLLECT_STATS
+    p.stats.nodeBytes += sizeof(Node);
+#endif
+    n->op = op;
+    n->token = tok;
+    n->left = left;
+    n->right = right;
+    n->value = 0;
+    n->operand = NO_OPERAND;
+    n->temp = -1;
+    n->symbol = NO_OPERAND;
+    n->mayTrap = false;
+    return n;
+}
+
+//These helpers give back a token's lexeme: lexemeText() points straight into the source line, and lexemeOf() makes a string copy only where one is really needed.
+const char* lexemeText(const Parser& p, const Token& tok) {
+    return tok.type == END_OF_FILE ? "EOF" : p.source + tok.offset;
+}
+
+int lexemeLength(const Token& tok) {
+    return tok.type == END_OF_FILE ? 3 : (int)tok.length;
+}
+
+string lexemeOf(const Parser& p, const Token& tok) {
+    return string(lexemeText(p, tok), lexemeLength(tok));
+}
+
+//tokenNames gives every TokenType the name used in error messages.
+static const char* const tokenNames[] = {
+    "identifier", "integer constant", "'='", "'+'", "'-'", "'*'", "'/'", "unary '-'", "'!'",
+    "'=='", "'!='", "'<'", "'<='", "'>'", "'>='", "'&&'", "'||'", "'('", "')'", "end of statement",
+    "float constant", "array identifier", "keyword", "'{'", "'}'", "','", "';'", "'^'", "'%'", "'++'", "'--'",
+    "'+='", "'-='", "'*='", "'/='", "'^='", "'%='", "invalid token", "temporary"
 };
+static_assert(sizeof(tokenNames) / sizeof(tokenNames[0]) == TEMP_REF + 1, "tokenNames needs one entry per TokenType");
+
+//describeToken() names the token that was found instead of the expected one; names, constants and keywords also show their text.
+string describeToken(const Parser& p, const Token& tok) {
+    if (tok.type == IDENT || tok.type == INT_LIT || tok.type == FLOAT_LIT || tok.type == ARRAY_ID || tok.type == KEYWORD) {
+        return string(tokenNames[tok.type]) + " '" + lexemeOf(p, tok) + "'";
+    }
+    return tokenNames[tok.type];
+}
 
-//These variables store the list of tokens from the input, track the current parsing position, number syntax rules for debugging, and build the postfix expression for intermediate code generation.
-vector<Token> tokens;
-int currentIndex = 0;
-int ruleId = 1;
-vector<string> postfix;
+/*
+badFactor() is the error for a token that can't start a factor. The C tokens the lexer knows (floats, array identifiers, % and ^, the
+compound assignments, braces and commas) are valid tokens but not part of the expression language, so the message says that instead.
+*/
+AnalysisError badFactor(const Parser& p, const Token& tok) {
+    if (tok.type >= FLOAT_LIT && tok.type < UNKNOWN) {
+        return AnalysisError{"syntax error: " + describeToken(p, tok) + " is not supported in expressions", tok.offset};
+    }
+    return AnalysisError{"syntax error: expected identifier, constant or '(' but got " + describeToken(p, tok), tok.offset};
+}
 
 //This function prints the token’s type and its actual text to see exactly what the parser is processing.
-void printToken(const Token& tok) {
-    printf("Token Num Code =\t%d\tLexeme =\t%s\n", tok.type + 10, tok.lexeme.c_str());
+void printToken(Parser& p, const Token& tok) {
+    if (p.mode != OUTPUT_FULL) return;
+    p.out << "Token Num Code =\t" << tok.type + 10 << "\tLexeme =\t";
+    p.out.write(lexemeText(p, tok), lexemeLength(tok)) << '\n';
 }
 
 //These functions print messages when entering and exiting grammar rules, helping you trace the parser step by step during syntax analysis.
-void enterRule(const string& name) {
-    cout << "enter<" << name << ">(" << ruleId++ << ")" << endl;
+void enterRule(Parser& p, const char* name) {
+    if (++p.callDepth > p.counters.maxCallDepth) p.counters.maxCallDepth = p.callDepth;
+    if (p.mode != OUTPUT_FULL) {
+        p.ruleId++;
+        return;
+    }
+    p.out << "enter<" << name << ">(" << p.ruleId++ << ")\n";
 }
 
-void exitRule(const string& name) {
-    cout << "exit<" << name << ">(" << (ruleId - 1) << ")" << endl;
+void exitRule(Parser& p, const char* name) {
+    p.callDepth--;
+    if (p.mode != OUTPUT_FULL) return;
+    p.out << "exit<" << name << ">(" << (p.ruleId - 1) << ")\n";
 }
 
 //This function returns the current token and then shifts the position to the following token in the input stream.
-Token nextToken() {
-    if (currentIndex >= (int)tokens.size()) {
-        return Token(END_OF_FILE, "EOF");
+Token nextToken(const Parser& p) {
+    if (p.currentIndex >= (int)p.tokens.size()) {
+        return Token(END_OF_FILE, 0, 0);
     }
-    return tokens[currentIndex];
+    return p.tokens[p.currentIndex];
 }
 
 //This function retrieves the current token and moves the pointer forward to prepare for reading the next token.
-Token lookahead() {
-    if (currentIndex >= (int)tokens.size()) {
-        return Token(END_OF_FILE, "EOF");
+Token lookahead(Parser& p) {
+    if (p.currentIndex >= (int)p.tokens.size()) {
+        return Token(END_OF_FILE, 0, 0);
     }
-    return tokens[currentIndex++];
+    return p.tokens[p.currentIndex++];
 }
 
 //This function checks if the current token matches the expected type, prints it if correct, moves to the next token, or reports a syntax error if it doesn't match.
-void match(TokenType expected) {
-    Token t = nextToken();
+void match(Parser& p, TokenType expected) {
+    Token t = nextToken(p);
     if (t.type == expected) {
-        printToken(t);
-        lookahead();
+        printToken(p, t);
+        lookahead(p);
     } else {
-        cerr << "Syntax error at assignment " << ruleId << ": Expected ";
-        cerr << expected << " but got " << t.type << " (" << t.lexeme << ")" << endl;
-        exit(1);
+        throw AnalysisError{string("syntax error: expected ") + tokenNames[expected] + " but got " + describeToken(p, t), t.offset};
     }
 }
 
-//These functions parse and evaluate arithmetic expressions, factor() handles variables and constants, term() manages multiplication and division, and expr() processes addition and subtraction.
-void factor();
-void term();
-void expr();
-void rel_expr();
-void eq_expr();
-void bool_and_expr();
-void bool_or_expr();
+//pushOperand() and pushOperator() append to the postfix expression; an operand is interned in the symbol table so only its id is kept.
+void pushOperand(Parser& p, const Token& tok) {
+    PostfixItem item = {tok.type, p.symbols.intern(p.source + tok.offset, tok.length)};
+    p.postfix.push_back(item);
+}
+
+void pushOperator(Parser& p, TokenType op) {
+    PostfixItem item = {op, NO_OPERAND};
+    p.postfix.push_back(item);
+}
+
+//These functions parse and evaluate arithmetic expressions, factor() handles variables and constants, term() manages multiplication and division, and expr() processes addition and subtraction. Each one returns the tree it built.
+Node* factor(Parser& p);
+Node* term(Parser& p);
+Node* expr(Parser& p);
+Node* rel_expr(Parser& p);
+Node* eq_expr(Parser& p);
+Node* bool_and_expr(Parser& p);
+Node* bool_or_expr(Parser& p);
+Node* prattExpr(Parser& p, int minLevel);
+Node* stackExpr(Parser& p);
+
+/*
+enterNesting() counts one more open parenthesis or unary operator, so a statement nested too deeply is an error instead of running out of stack.
+The limit is --max-nesting; the recursive parsers can't go above MAX_NESTING, the explicit-stack parser has no limit of its own.
+*/
+#define MAX_NESTING 4096
+
+void enterNesting(Parser& p, const Token& t) {
+#ifdef COLLECT_STATS
+    if (p.depth + 1 > p.stats.maxNesting) p.stats.maxNesting = p.depth + 1;
+#endif
+    if (++p.depth > p.maxNesting && p.maxNesting > 0) {
+        throw AnalysisError{"syntax error: expression nested more than " + to_string(p.maxNesting) + " levels deep", t.offset};
+    }
+}
 
 //The factor() function handles the smallest units in an expression, such as identifiers or constants, and prints the token if it's valid.
-void factor() {
-    enterRule("factor");
-    Token t = nextToken();
-    if (t.type == IDENT || t.type == INT_CONST) {
-        printToken(t);
-        postfix.push_back(t.lexeme);
-        lookahead();
+Node* factor(Parser& p) {
+    enterRule(p, "factor");
+    Token t = nextToken(p);
+    Node* node;
+    if (t.type == IDENT || t.type == INT_LIT) {
+        printToken(p, t);
+        pushOperand(p, t);
+        node = newNode(p, t.type, t, NULL, NULL);
+        lookahead(p);
     //This line handles expressions wrapped in parentheses by recursively parsing the inner expression using bool_or_expr() and ensuring it is properly closed with a matching right parenthesis.
     } else if (t.type == LEFT_PAREN) {
-        printToken(t);
-        lookahead();
-        bool_or_expr();
-        match(RIGHT_PAREN);
+        printToken(p, t);
+        lookahead(p);
+        enterNesting(p, t);
+        node = p.parser == PARSER_PRATT ? prattExpr(p, 1) : bool_or_expr(p);
+        match(p, RIGHT_PAREN);
+        p.depth--;
     //Handles a unary minus (-) or logical NOT (!) by consuming the operator, recursively parsing the following factor, and appending the operator to the postfix expression.
     } else if (t.type == SUB_OP || t.type == BNOT_OP) { 
-        printToken(t);
-        lookahead();
-        factor();
-        postfix.push_back(t.lexeme);
-    // Reports a syntax error and terminates the program if the token does not match any valid <factor> 
+        printToken(p, t);
+        lookahead(p);
+        enterNesting(p, t);
+        Node* operand = factor(p);
+        p.depth--;
+        TokenType op = t.type == SUB_OP ? UNARY_MINUS : BNOT_OP;
+        pushOperator(p, op);
+        node = newNode(p, op, t, operand, NULL);
+    // Reports a syntax error if the token does not match any valid <factor> 
     } else {
-        cerr << "Syntax error in factor: Unexpected token " << t.lexeme << endl;
-        exit(1);
+        throw badFactor(p, t);
     }
-    exitRule("factor");
+    exitRule(p, "factor");
+    return node;
 }
 
 //The term() function parses a term, starting with a factor, and repeatedly handles multiplication or division operations if they follow.
-void term() {
-    enterRule("term");
-    factor();
-    while (nextToken().type == MULT_OP || nextToken().type == DIV_OP) {
-        Token op = nextToken();
+Node* term(Parser& p) {
+    enterRule(p, "term");
+    Node* node = factor(p);
+    while (nextToken(p).type == MULT_OP || nextToken(p).type == DIV_OP) {
+        Token op = nextToken(p);
     //This block processes a multiplication or division operator by printing it, consuming it, parsing the next factor, and appending the operator to the postfix expression.
-        printToken(op);
-        lookahead();
-        factor();
-        postfix.push_back(op.lexeme);
+        printToken(p, op);
+        lookahead(p);
+        Node* right = factor(p);
+        pushOperator(p, op.type);
+        node = newNode(p, op.type, op, node, right);
     }
-    exitRule("term");
+    exitRule(p, "term");
+    return node;
 }
 
 //The expr() function begins parsing an expression by handling terms and continues processing as long as the next token is an addition or subtraction operator.
-void expr() {
-    enterRule("expr");
-    term();
-    while (nextToken().type == ADD_OP || nextToken().type == SUB_OP) {
-        Token op = nextToken();
+Node* expr(Parser& p) {
+    enterRule(p, "expr");
+    Node* node = term(p);
+    while (nextToken(p).type == ADD_OP || nextToken(p).type == SUB_OP) {
+        Token op = nextToken(p);
     //This block handles addition or subtraction by printing and consuming the operator, parsing the next term, and appending the operator to the postfix expression.
-        printToken(op);
-        lookahead();
-        term();
-        postfix.push_back(op.lexeme);
+        printToken(p, op);
+        lookahead(p);
+        Node* right = term(p);
+        pushOperator(p, op.type);
+        node = newNode(p, op.type, op, node, right);
     }
-    exitRule("expr");
+    exitRule(p, "expr");
+    return node;
 }
 
 //The rel_expr() function enters the relational expression rule, parses an expression, and processes relational operators if present.
-void rel_expr() {
-    enterRule("rel_expr");
-    expr();
-    if (nextToken().type >= RLT_OP && nextToken().type <= RGEQ_OP) {
-        Token op = nextToken();
+Node* rel_expr(Parser& p) {
+    enterRule(p, "rel_expr");
+    Node* node = expr(p);
+    if (nextToken(p).type >= RLT_OP && nextToken(p).type <= RGEQ_OP) {
+        Token op = nextToken(p);
     //This block processes a relational operator by printing and consuming it, parsing the right-hand expression, and appending the operator to the postfix expression.
-        printToken(op);
-        lookahead();
-        expr();
-        postfix.push_back(op.lexeme);
+        printToken(p, op);
+        lookahead(p);
+        Node* right = expr(p);
+        pushOperator(p, op.type);
+        node = newNode(p, op.type, op, node, right);
     }
-    exitRule("rel_expr");
+    exitRule(p, "rel_expr");
+    return node;
 }
 
 //The eq_expr() function starts the equality expression rule and checks for == or != comparisons.
-void eq_expr() {
-    enterRule("equal_expr");
-    rel_expr();
-    if (nextToken().type == REQ_OP || nextToken().type == RNEQ_OP) {
-        Token op = nextToken();
+Node* eq_expr(Parser& p) {
+    enterRule(p, "equal_expr");
+    Node* node = rel_expr(p);
+    if (nextToken(p).type == REQ_OP || nextToken(p).type == RNEQ_OP) {
+        Token op = nextToken(p);
     //This code handles an equality operator (== or !=) by printing and consuming it, parsing the right-hand relational expression, and appending the operator to the postfix expression.
-        printToken(op);
-        lookahead();
-        rel_expr();
-        postfix.push_back(op.lexeme);
+        printToken(p, op);
+        lookahead(p);
+        Node* right = rel_expr(p);
+        pushOperator(p, op.type);
+        node = newNode(p, op.type, op, node, right);
     }
-    exitRule("equal_expr");
+    exitRule(p, "equal_expr");
+    return node;
 }
 
 //The bool_and_expr() function handles logical AND (&&) expressions.
-void bool_and_expr() {
-    enterRule("bool_and_expr");
-    eq_expr();
-    while (nextToken().type == BAND_OP) {
-        Token op = nextToken();
+Node* bool_and_expr(Parser& p) {
+    enterRule(p, "bool_and_expr");
+    Node* node = eq_expr(p);
+    while (nextToken(p).type == BAND_OP) {
+        Token op = nextToken(p);
     //This code processes the logical AND (&&) operator by printing and consuming it, parsing the next equality expression, and adding the operator to the postfix expression.
-        printToken(op);
-        lookahead();
-        eq_expr();
-        postfix.push_back(op.lexeme);
+        printToken(p, op);
+        lookahead(p);
+        Node* right = eq_expr(p);
+        pushOperator(p, op.type);
+        node = newNode(p, op.type, op, node, right);
     }
-    exitRule("bool_and_expr");
+    exitRule(p, "bool_and_expr");
+    return node;
 }
 
 //The bool_or_expr() function handles logical OR (||) expressions.
-void bool_or_expr() {
-    enterRule("bool_or_expr");
-    bool_and_expr();
-    while (nextToken().type == BOR_OP) {
-        Token op = nextToken();
+Node* bool_or_expr(Parser& p) {
+    enterRule(p, "bool_or_expr");
+    Node* node = bool_and_expr(p);
+    while (nextToken(p).type == BOR_OP) {
+        Token op = nextToken(p);
     //This code handles the logical OR (||) operator by printing and consuming it, parsing the next boolean AND expression, and appending the operator to the postfix expression.
-        printToken(op);
-        lookahead();
-        bool_and_expr();
-        postfix.push_back(op.lexeme);
+        printToken(p, op);
+        lookahead(p);
+        Node* right = bool_and_expr(p);
+        pushOperator(p, op.type);
+        node = newNode(p, op.type, op, node, right);
     }
-    exitRule("bool_or_expr");
+    exitRule(p, "bool_or_expr");
+    return node;
 }
 
 //The assign() function parses an assignment statement and handles the full boolean expression on the right-hand side.
-void assign() {
-    enterRule("assign");
-    Token id = nextToken();
+void assign(Parser& p) {
+    enterRule(p, "assign");
+    Token id = nextToken(p);
     if (id.type != IDENT) {
-        cerr << "Syntax error: Expected identifier at start of assignment" << endl;
-        exit(1);
+        throw AnalysisError{"syntax error: expected identifier at start of assignment but got " + describeToken(p, id), id.offset};
     }
     //This code handles an assignment statement by printing and consuming the identifier, matching the assignment operator (=), parsing the right-hand expression, and appending the identifier and = symbol to the postfix expression to reflect the assignment.
-    printToken(id);
-    lookahead();
-    match(ASSIGN_OP);
-    bool_or_expr();
-    postfix.push_back(id.lexeme);
-    postfix.push_back("=");
-    exitRule("assign");
-}
-
-//The generateIC() function generates intermediate code from the postfix expression.
-void generateIC(const vector<string>& postfix) {
-    cout << "\n-----------------------INTERMEDIATE CODE GENERATOR-----------------------" << endl;
-    stack<string> s;
-    char tempName = 'A';
-
-//This block initializes a map that associates arithmetic operator symbols with their corresponding intermediate code operation names for use during code generation.
-    map<string, string> opMap;
-    opMap["+"] = "add";
-    opMap["-"] = "sub";
-    opMap["*"] = "mul";
-    opMap["/"] = "div";
-//This block maps logical and equality operators to their corresponding intermediate code instruction names used in the Intermediate Code Generator.
-    opMap["&&"] = "band";
-    opMap["||"] = "bor";
-    opMap["!"] = "bnot";
-    opMap["=="] = "req";
-    opMap["!="] = "rneq";
-//This block maps relational operators to their intermediate code instruction names used for generating intermediate representation.
-    opMap["<"] = "rlt";
-    opMap["<="] = "rleq";
-    opMap[">"] = "rgt";
-    opMap[">="] = "rgeq";
-//This loop goes through each item in the postfix expression, and when it sees an assignment (=), it takes two values from the stack—one for the right-hand side and one for the left-hand side—to create an assignment instruction.
-    for (size_t i = 0; i < postfix.size(); ++i) {
-        string token = postfix[i];
-        if (token == "=") {
-            string rhs = s.top(); s.pop();
-            string lhs = s.top(); s.pop();
-            //This prints the top two values being removed from the stack and shows the assignment instruction being created from them.
-            cout << "top " << rhs << endl << "pop()\n";
-            cout << "top " << lhs << endl << "pop()\n";
-            cout << "assign " << lhs << ", " << rhs << endl;
-        //This checks if the token is an operator, and if it's a logical NOT (!), it pops one value from the stack, creates a temporary variable, and prepares to generate intermediate code for the NOT operation.
-        } else if (opMap.count(token)) {
-            if (token == "!") {
-                string a = s.top(); s.pop();
-                string temp = string(1, tempName++);
-            //This prints the top value being popped from the stack, generates the intermediate code for the logical NOT (bnot) operation, and then pushes the result as a temporary variable back onto the stack
-                cout << "top " << a << "\npop()\n";
-                cout << "bnot, " << a << ", " << temp << endl;
-                cout << "push " << temp << endl;
-            //This checks if the minus sign is used as a unary operator, then pops that item, creates a temporary variable for the result, and prepares to generate the intermediate code for unary minus.
-                s.push(temp);
-            } else if (token == "-" && s.size() == 1) {
-                string a = s.top(); s.pop();
-                string temp = string(1, tempName++);
-            //This prints the steps for applying unary minus to a value: showing the value being popped, generating the uminus operation, pushing the result to the stack, and storing it in a temporary variable.
-                cout << "top " << a << "\npop()\n";
-                cout << "uminus, " << a << ", " << temp << endl;
-                cout << "push " << temp << endl;
-                s.push(temp);
-            //This handles binary operators by popping two values from the stack, creating a new temporary variable to store the result, and preparing for intermediate code generation.
-            } else {
-                string b = s.top(); s.pop();
-                string a = s.top(); s.pop();
-                string temp = string(1, tempName++);
-            //This prints the operation steps: shows which operands are popped from the stack, prints the intermediate code instruction using the mapped operator name, pushes the result temp variable back onto the stack for future use.
-                cout << token << "\ntop " << b << "\npop()\ntop " << a << "\npop()\n";
-                cout << opMap[token] << ", " << a << ", " << b << ", " << temp << endl;
-                cout << "push " << temp << endl;
-                s.push(temp);
-            }
-            //This handles operands by printing a push instruction and placing them onto the stack for later operations.
+    printToken(p, id);
+    lookahead(p);
+    Token assignOp = nextToken(p);
+    match(p, ASSIGN_OP);
+    Node* rhs;
+    if (p.parser == PARSER_PRATT) rhs = prattExpr(p, 1);
+    else if (p.parser == PARSER_STACK) rhs = stackExpr(p);
+    else rhs = bool_or_expr(p);
+    //The expression has to use up the whole statement; anything left over (z = a b, or a second comparison in a < b < c) is an error.
+    Token end = nextToken(p);
+    if (end.type != END_OF_FILE) {
+        throw AnalysisError{"syntax error: expected end of statement but got " + describeToken(p, end), end.offset};
+    }
+    pushOperand(p, id);
+    pushOperator(p, ASSIGN_OP);
+    p.ast = newNode(p, ASSIGN_OP, assignOp, newNode(p, IDENT, id, NULL, NULL), rhs);
+    exitRule(p, "assign");
+}
+
+/*****************************************************/
+/*
+Pratt parser (--parser pratt)
+
+prattExpr() parses the same expressions as bool_or_expr() with a single loop: after an operand, every binary operator whose level is at
+least minLevel is taken, and its right side is parsed one level higher, so operators bind left to right and tighter levels first.
+factor() is shared with the recursive parser. The comparisons don't chain (a < b < c stops after a < b, just like rel_expr() and
+eq_expr() do), so after one of them only lower levels may follow.
+*/
+
+//BindingPower is the precedence level of a binary operator (0 for every other token, which ends the expression) and whether it chains.
+struct BindingPower {
+    int level;
+    bool nonAssoc;
+};
+
+struct BindingPowerTable {
+    BindingPower power[TEMP_REF + 1];
+};
+
+#define MAX_LEVEL 6
+
+constexpr BindingPowerTable buildBindingPowers() {
+    BindingPowerTable t = {};
+    t.power[BOR_OP] = {1, false};
+    t.power[BAND_OP] = {2, false};
+    t.power[REQ_OP] = {3, true};
+    t.power[RNEQ_OP] = {3, true};
+    t.power[RLT_OP] = {4, true};
+    t.power[RLEQ_OP] = {4, true};
+    t.power[RGT_OP] = {4, true};
+    t.power[RGEQ_OP] = {4, true};
+    t.power[ADD_OP] = {5, false};
+    t.power[SUB_OP] = {5, false};
+    t.power[MULT_OP] = {6, false};
+    t.power[DIV_OP] = {6, false};
+    return t;
+}
+
+static constexpr BindingPowerTable bindingPowers = buildBindingPowers();
+
+//prattExpr() reads the next token in place (the token list always ends with END_OF_FILE, which has level 0) instead of copying it.
+Node* prattExpr(Parser& p, int minLevel) {
+    enterRule(p, "pratt_expr");
+    Node* node = factor(p);
+    int maxLevel = MAX_LEVEL;
+    for (;;) {
+        const Token& op = p.tokens[p.currentIndex];
+        BindingPower bp = bindingPowers.power[op.type];
+        if (bp.level < minLevel || bp.level > maxLevel) break;
+    //This block takes the operator, parses its right side one level higher, and appends the operator to the postfix expression.
+        printToken(p, op);
+        Token t = p.tokens[p.currentIndex++];
+        Node* right = prattExpr(p, bp.level + 1);
+        pushOperator(p, t.type);
+        node = newNode(p, t.type, t, node, right);
+        maxLevel = bp.nonAssoc ? bp.level - 1 : bp.level;
+    }
+    exitRule(p, "pratt_expr");
+    return node;
+}
+
+/*****************************************************/
+/*
+Explicit-stack parser (--parser stack)
+
+stackExpr() is bool_or_expr() with the call stack kept in p.frames: every open rule is a StackFrame, and the rules are entered and left
+in exactly the order the recursive functions would, so the trace, the postfix and the errors are the same. The precedence level of a
+rule's operators comes from bindingPowers (bool_or_expr is level 1, term level 6). Its depth is only limited by memory, which lets
+--max-nesting go far beyond MAX_NESTING.
+*/
+enum StackRule {
+    RULE_BOOL_OR, RULE_BOOL_AND, RULE_EQ, RULE_REL, RULE_EXPR, RULE_TERM, RULE_FACTOR
+};
+
+//These are the places a rule can be in: just entered, after its first operand, after an operator's right side, inside parentheses, or after a unary operator's operand.
+enum StackState {
+    STATE_START, STATE_LEFT, STATE_RIGHT, STATE_PAREN, STATE_UNARY
+};
+
+static const char* const stackRuleNames[] = {
+    "bool_or_expr", "bool_and_expr", "equal_expr", "rel_expr", "expr", "term", "factor"
+};
+
+void pushFrame(Parser& p, int rule) {
+    StackFrame f = {0, (unsigned char)rule, STATE_START};
+    p.frames.push_back(f);
+}
+
+//stackFactor() runs one step of factor(): the frame on top is a factor that has just been entered or whose inner expression is done.
+void stackFactor(Parser& p) {
+    StackFrame& f = p.frames.back();
+    if (f.state == STATE_PAREN) {
+        match(p, RIGHT_PAREN);
+        p.depth--;
+    } else if (f.state == STATE_UNARY) {
+        p.depth--;
+        const Token& t = p.tokens[f.opIndex];
+        TokenType op = t.type == SUB_OP ? UNARY_MINUS : BNOT_OP;
+        pushOperator(p, op);
+        p.nodes.back() = newNode(p, op, t, p.nodes.back(), NULL);
+    } else {
+        enterRule(p, "factor");
+        const Token& t = p.tokens[p.currentIndex];
+        if (t.type == IDENT || t.type == INT_LIT) {
+            printToken(p, t);
+            pushOperand(p, t);
+            p.nodes.push_back(newNode(p, t.type, t, NULL, NULL));
+            p.currentIndex++;
+    //A parenthesis or a unary operator leaves the factor open and starts the inner expression or factor above it.
+        } else if (t.type == LEFT_PAREN) {
+            printToken(p, t);
+            p.currentIndex++;
+            enterNesting(p, t);
+            f.state = STATE_PAREN;
+            pushFrame(p, RULE_BOOL_OR);
+            return;
+        } else if (t.type == SUB_OP || t.type == BNOT_OP) {
+            printToken(p, t);
+            f.opIndex = p.currentIndex++;
+            enterNesting(p, t);
+            f.state = STATE_UNARY;
+            pushFrame(p, RULE_FACTOR);
+            return;
         } else {
-            cout << "push " << token << endl;
-            s.push(token);
+            throw badFactor(p, t);
         }
     }
+    exitRule(p, "factor");
+    p.frames.pop_back();
 }
 
-//This function breaks the input line into tokens by skipping spaces and preparing to identify identifiers, numbers, or symbols.
-vector<Token> tokenize(const string& line) {
-    vector<Token> result;
-    size_t i = 0;
-    while (i < line.length()) {
-        if (isspace(line[i])) { i++; continue; }
-    //This block identifies variable names made of letters, digits, or underscores by collecting characters into a string until the pattern ends.
-        if (isalpha(line[i]) || line[i] == '_') {
-            string id;
-            while (i < line.length() && (isalnum(line[i]) || line[i] == '_')) {
-                id += line[i++];
-            }
-        //This part checks if the input is a number, gathers the full numeric constant, and adds it to the list of tokens.
-            result.push_back(Token(IDENT, id));
-        } else if (isdigit(line[i])) {
-            string num;
-            while (i < line.length() && isdigit(line[i])) {
-                num += line[i++];
+Node* stackExpr(Parser& p) {
+    p.frames.clear();
+    p.nodes.clear();
+    pushFrame(p, RULE_BOOL_OR);
+    while (!p.frames.empty()) {
+        StackFrame& f = p.frames.back();
+        int rule = f.rule;
+        if (rule == RULE_FACTOR) {
+            stackFactor(p);
+            continue;
+        }
+        if (f.state == STATE_START) {
+            enterRule(p, stackRuleNames[rule]);
+            f.state = STATE_LEFT;
+            pushFrame(p, rule + 1);
+            continue;
+        }
+    //When the right side of an operator is done, the operator is appended to the postfix expression and joins the two trees.
+        if (f.state == STATE_RIGHT) {
+            Node* right = p.nodes.back();
+            p.nodes.pop_back();
+            const Token& op = p.tokens[f.opIndex];
+            pushOperator(p, op.type);
+            p.nodes.back() = newNode(p, op.type, op, p.nodes.back(), right);
+        }
+    //Another operator of this rule's level continues it; a comparison is only taken once, as in rel_expr() and eq_expr().
+        const Token& next = p.tokens[p.currentIndex];
+        BindingPower bp = bindingPowers.power[next.type];
+        if (bp.level == rule + 1 && !(bp.nonAssoc && f.state == STATE_RIGHT)) {
+            printToken(p, next);
+            f.opIndex = p.currentIndex++;
+            f.state = STATE_RIGHT;
+            pushFrame(p, rule + 1);
+        } else {
+            exitRule(p, stackRuleNames[rule]);
+            p.frames.pop_back();
+        }
+    }
+    return p.nodes.back();
+}
+
+/*****************************************************/
+/*
+Fold pass (--fold)
+
+foldStatement() runs between assign() and generateIC(). It rewrites the tree of the statement bottom-up: operations whose operands are all
+constants are replaced by their value, and identities (x + 0, x * 1, x * 0, x / 1, - -x, !!x on a comparison) drop the operation.
+Then the postfix expression is rebuilt from the tree, so the intermediate code only has the instructions that are left.
+*/
+
+//constantOf() tells whether a node is a constant whose value fits in a long long, and gives the value.
+bool constantOf(const Parser& p, const Node* n, long long& v) {
+    if (n->op != INT_LIT) return false;
+    if (n->operand != NO_OPERAND) {
+        v = n->value;
+        return true;
+    }
+    const char* s = p.source + n->token.offset;
+    v = 0;
+    for (unsigned i = 0; i < n->token.length; ++i) {
+        if (__builtin_mul_overflow(v, 10LL, &v) || __builtin_add_overflow(v, (long long)(s[i] - '0'), &v)) return false;
+    }
+    return true;
+}
+
+//makeConstant() turns a node into the constant v; the value is interned like any other operand so it can be printed.
+Node* makeConstant(Parser& p, Node* n, long long v) {
+    char digits[24];
+    int len = snprintf(digits, sizeof(digits), "%lld", v);
+    n->op = INT_LIT;
+    n->left = NULL;
+    n->right = NULL;
+    n->value = v;
+    n->operand = p.symbols.intern(digits, len);
+    n->mayTrap = false;
+    return n;
+}
+
+//isBoolean() is true for operations whose result is always 0 or 1.
+bool isBoolean(const Node* n) {
+    return n->op >= BNOT_OP && n->op <= BOR_OP;
+}
+
+//evaluate() computes a binary operation on two constants. It returns false when the result can't be known at compile time (division by zero, overflow).
+bool evaluate(TokenType op, long long a, long long b, long long& r) {
+    switch (op) {
+        case ADD_OP: return !__builtin_add_overflow(a, b, &r);
+        case SUB_OP: return !__builtin_sub_overflow(a, b, &r);
+        case MULT_OP: return !__builtin_mul_overflow(a, b, &r);
+        case DIV_OP:
+            if (b == 0 || (b == -1 && a == (-9223372036854775807LL - 1))) return false;
+            r = a / b;
+            return true;
+        case REQ_OP: r = a == b; return true;
+        case RNEQ_OP: r = a != b; return true;
+        case RLT_OP: r = a < b; return true;
+        case RLEQ_OP: r = a <= b; return true;
+        case RGT_OP: r = a > b; return true;
+        case RGEQ_OP: r = a >= b; return true;
+        case BAND_OP: r = a && b; return true;
+        case BOR_OP: r = a || b; return true;
+        default: return false;
+    }
+}
+
+/*
+rewriteTree() replaces every node of the tree under *root, bottom-up, by what visit() returns for it: the children of a node (left first)
+are done before the node itself, exactly like a recursive walk, but on the explicit stack p.walk. It goes down the left children to a
+leaf, then climbs back up, turning to the right child of every operation that has one.
+*/
+template <Node* (*visit)(Parser&, Node*)>
+void rewriteTree(Parser& p, Node** root) {
+    vector<TreeFrame>& stack = p.walk;
+    stack.clear();
+    Node** link = root;
+    for (;;) {
+        Node* n = *link;
+        while (n->left != NULL) {
+            TreeFrame f = {n, link, false};
+            stack.push_back(f);
+            link = &n->left;
+            n = n->left;
+        }
+        *link = visit(p, n);
+        for (;;) {
+            if (stack.empty()) return;
+            TreeFrame& f = stack.back();
+            if (!f.expanded && f.node->right != NULL) {
+                f.expanded = true;
+                link = &f.node->right;
+                break;
             }
-        //This section handles multi-character operators by checking the next two characters and identifying them as a single token if matched.
-            result.push_back(Token(INT_CONST, num));
+            Node* done = f.node;
+            Node** doneLink = f.link;
+            stack.pop_back();
+            *doneLink = visit(p, done);
+        }
+    }
+}
+
+/*
+foldNode() folds one node whose children are already folded. It also works out mayTrap, so an identity that drops an operand (x * 0,
+0 && x, 1 || x) is only applied when the dropped operand can't divide by zero: that division still happens, and is counted, at run time.
+*/
+Node* foldNode(Parser& p, Node* n) {
+    if (n->left == NULL) return n;
+    long long a, b = 0, r;
+    bool constA = constantOf(p, n->left, a);
+    bool constB = n->right != NULL && constantOf(p, n->right, b);
+    n->mayTrap = n->left->mayTrap || (n->right != NULL && n->right->mayTrap) || (n->op == DIV_OP && !(constB && b != 0));
+//These handle the unary operations: a constant operand is folded, and a double negation or a double NOT of a comparison disappears.
+    if (n->right == NULL) {
+        if (constA && n->op == UNARY_MINUS && a != (-9223372036854775807LL - 1)) {
+            p.counters.folded++;
+            return makeConstant(p, n, -a);
+        }
+        if (constA && n->op == BNOT_OP) {
+            p.counters.folded++;
+            return makeConstant(p, n, !a);
+        }
+        if (n->op == UNARY_MINUS && n->left->op == UNARY_MINUS) {
+            p.counters.simplified++;
+            return n->left->left;
+        }
+        if (n->op == BNOT_OP && n->left->op == BNOT_OP && isBoolean(n->left->left)) {
+            p.counters.simplified++;
+            return n->left->left;
+        }
+        return n;
+    }
+    if (constA && constB && evaluate(n->op, a, b, r)) {
+        p.counters.folded++;
+        return makeConstant(p, n, r);
+    }
+//These apply the identities. Expressions have no side effects other than a division by zero, so an operand that doesn't matter and
+//can't trap can simply be dropped.
+    if ((n->op == ADD_OP && constB && b == 0) || (n->op == SUB_OP && constB && b == 0) ||
+        (n->op == MULT_OP && constB && b == 1) || (n->op == DIV_OP && constB && b == 1)) {
+        p.counters.simplified++;
+        return n->left;
+    }
+    if ((n->op == ADD_OP && constA && a == 0) || (n->op == MULT_OP && constA && a == 1)) {
+        p.counters.simplified++;
+        return n->right;
+    }
+    if (n->op == MULT_OP && ((constA && a == 0 && !n->right->mayTrap) || (constB && b == 0 && !n->left->mayTrap))) {
+        p.counters.simplified++;
+        return makeConstant(p, n, 0);
+    }
+    if ((n->op == BAND_OP && ((constA && a == 0 && !n->right->mayTrap) || (constB && b == 0 && !n->left->mayTrap))) ||
+        (n->op == BOR_OP && ((constA && a != 0 && !n->right->mayTrap) || (constB && b != 0 && !n->left->mayTrap)))) {
+        p.counters.simplified++;
+        return makeConstant(p, n, n->op == BOR_OP);
+    }
+    return n;
+}
+
+//linearize() writes a tree back out as postfix, operands before their operator, exactly as the parser does. It walks like rewriteTree().
+void linearize(Parser& p, Node* root) {
+    vector<TreeFrame>& stack = p.walk;
+    stack.clear();
+    Node* n = root;
+    for (;;) {
+        while (n->left != NULL) {
+            TreeFrame f = {n, NULL, false};
+            stack.push_back(f);
+            n = n->left;
+        }
+        if (n->operand != NO_OPERAND) {
+            PostfixItem item = {n->op, n->operand};
+            p.postfix.push_back(item);
         } else {
-            string twoChar = line.substr(i, 2);
-            if (twoChar == "==" || twoChar == "!=" || twoChar == "<=" || 
-                twoChar == ">=" || twoChar == "&&" || twoChar == "||") {
-            //This block adds the correct token type to the result list based on which two-character operator is found.
-                if (twoChar == "==") result.push_back(Token(REQ_OP, twoChar));
-                else if (twoChar == "!=") result.push_back(Token(RNEQ_OP, twoChar));
-                else if (twoChar == "<=") result.push_back(Token(RLEQ_OP, twoChar));
-                else if (twoChar == ">=") result.push_back(Token(RGEQ_OP, twoChar));
-                else if (twoChar == "&&") result.push_back(Token(BAND_OP, twoChar));
-            //This part handles the remaining two-character case || as a binary OR operator, then checks for single-character operators like =, converting them into appropriate tokens.
-                else result.push_back(Token(BOR_OP, twoChar));
-                i += 2;
-            } else {
-                char c = line[i++];
-                if (c == '=') result.push_back(Token(ASSIGN_OP, "="));
-            //This section checks for single-character arithmetic and relational operators, converting each one into the correct token type for the analyzer to process.
-                else if (c == '+') result.push_back(Token(ADD_OP, "+"));
-                else if (c == '-') result.push_back(Token(SUB_OP, "-"));
-                else if (c == '*') result.push_back(Token(MULT_OP, "*"));
-                else if (c == '/') result.push_back(Token(DIV_OP, "/"));
-                else if (c == '<') result.push_back(Token(RLT_OP, "<"));
-            //This block handles remaining single-character operators and parentheses, and reports a lexical error if the character doesn't match any valid token type.
-                else if (c == '>') result.push_back(Token(RGT_OP, ">"));
-                else if (c == '(') result.push_back(Token(LEFT_PAREN, "("));
-                else if (c == ')') result.push_back(Token(RIGHT_PAREN, ")"));
-                else {
-                    cerr << "Lexical error: Invalid character '" << c << "'" << endl;
-                    exit(1);
-                }
+            pushOperand(p, n->token);
+        }
+        for (;;) {
+            if (stack.empty()) return;
+            TreeFrame& f = stack.back();
+            if (!f.expanded && f.node->right != NULL) {
+                f.expanded = true;
+                n = f.node->right;
+                break;
             }
+            pushOperator(p, f.node->op);
+            stack.pop_back();
         }
     }
-    //This code adds an end_of_file token to signal the end of the input and then returns the full list of tokens for parsing.
-    result.push_back(Token(END_OF_FILE, "EOF"));
-    return result;
 }
-//This code starts the main function, opens the input file front.in, and checks if it's accessible and if not, it prints an error and exits the program.
-int main() {
-    ifstream fin("front.in");
-    if (!fin.is_open()) {
-        cerr << "Error: Could not open front.in" << endl;
-        return 1;
+
+//countOperators() counts the postfix items that become an instruction.
+long long countOperators(const vector<PostfixItem>& postfix) {
+    long long count = 0;
+    for (size_t i = 0; i < postfix.size(); ++i) {
+        if (postfix[i].operand == NO_OPERAND) count++;
     }
-//These lines initialize a string to hold each input line and a counter for assignment blocks, then loop through each line in the file, skipping any empty lines.
-    string line;
-    int assignmentNumber = 1;
+    return count;
+}
 
-    while (getline(fin, line)) {
-        if (line.empty()) continue;
-//These lines print the current line being processed, mark the start of a new assignment, tokenize the line into tokens, reset parsing state, and clear the postfix expression list to prepare for the next analysis.
-        cout << "\nProcessing line: " << line << endl;
-        cout << "\n-----------------------START ASSIGNMENT " << assignmentNumber << "-----------------------" << endl;
+void foldStatement(Parser& p) {
+    long long before = countOperators(p.postfix);
+    rewriteTree<foldNode>(p, &p.ast->right);
+    p.postfix.clear();
+    linearize(p, p.ast->right);
+    linearize(p, p.ast->left);
+    pushOperator(p, ASSIGN_OP);
+    p.counters.eliminated += before - countOperators(p.postfix);
+}
 
-        tokens = tokenize(line);
-        currentIndex = 0;
-        ruleId = 1;
-        postfix.clear();
-//This prints a header to indicate the start of parsing, then begins parsing the assignment expression using the assign() function.
-        cout << "-----------------------PARSING TREE-----------------------" << endl;
-        assign();
-//This prints a header, then outputs the entire postfix expression generated during parsing by iterating through the postfix vector.
-        cout << "\n-----------------------POSTFIX EXPRESSION-----------------------\n";
-        for (size_t i = 0; i < postfix.size(); ++i) {
-            cout << postfix[i] << " ";
+/*****************************************************/
+/*
+Common subexpression elimination (--cse)
+
+hashCons() turns the statement's tree into a DAG: walking bottom-up, every node is looked up in p.dag by its opcode and its (already
+canonical) children, so two identical subexpressions end up as the same node. linearizeShared() then writes the DAG as postfix; the first
+time an operation is written it gets the next temporary, and every later use is a TEMP_REF item that just pushes that temporary again.
+*/
+
+//leafSymbol() gives the symbol id of an operand node.
+int leafSymbol(Parser& p, const Node* n) {
+    if (n->operand != NO_OPERAND) return n->operand;
+    if (n->symbol != NO_OPERAND) return n->symbol;
+    return p.symbols.intern(p.source + n->token.offset, n->token.length);
+}
+
+//versionOf() is how many times a variable has been assigned so far in the block.
+int versionOf(const Parser& p, int symbol) {
+    return symbol < (int)p.versions.size() ? p.versions[symbol] : 0;
+}
+
+//hashCons() looks up one node whose children are already canonical; rewriteTree() walks the tree with it.
+Node* hashCons(Parser& p, Node* n) {
+    if (n->left == NULL) {
+        n->symbol = leafSymbol(p, n);
+        return p.dag.find(n->op, n->symbol, n->op == IDENT ? versionOf(p, n->symbol) : 0, n);
+    }
+    return p.dag.find(n->op, (long long)(size_t)n->left, (long long)(size_t)n->right, n);
+}
+
+/*
+linearizeShared() walks the DAG like linearize(). An operation that already has its temporary is not walked again but written as a
+TEMP_REF; since the left side is always finished before the right one, the first visit of a shared node is the one that expands it.
+*/
+void linearizeShared(Parser& p, Node* root, int& nextTemp) {
+    vector<TreeFrame>& stack = p.walk;
+    stack.clear();
+    Node* n = root;
+    for (;;) {
+        while (n->left != NULL && n->temp < 0) {
+            TreeFrame f = {n, NULL, false};
+            stack.push_back(f);
+            n = n->left;
+        }
+        if (n->left == NULL) {
+            PostfixItem item = {n->op, leafSymbol(p, n)};
+            p.postfix.push_back(item);
+        } else {
+            PostfixItem item = {TEMP_REF, tempOperand(n->temp)};
+            p.postfix.push_back(item);
+        }
+        for (;;) {
+            if (stack.empty()) return;
+            TreeFrame& f = stack.back();
+            if (!f.expanded && f.node->right != NULL) {
+                f.expanded = true;
+                n = f.node->right;
+                break;
+            }
+            pushOperator(p, f.node->op);
+            f.node->temp = nextTemp++;
+            stack.pop_back();
         }
-        cout << endl;
-//This calls the intermediate code generator to simulate execution of the postfix expression, prints an end marker for the assignment, then continues to the next input line and closes the file when done.
-        generateIC(postfix);
-        cout << "\n-----------------------END Assignment " << assignmentNumber++ << "-----------------------\n";
     }
+}
 
-    fin.close();
-    return 0;
-}
\ No newline at end of file
+/*
+shareStatement() runs the pass on the current statement. In block mode the table, the versions and the temporaries (numbered on from
+p.nextTemp) carry over from the previous statements of the line, and the assigned variable gets a new version at the end.
+*/
+void shareStatement(Parser& p) {
+    long long before = countOperators(p.postfix);
+    rewriteTree<hashCons>(p, &p.ast->right);
+    p.postfix.clear();
+    p.tempBase = p.nextTemp;
+    linearizeShared(p, p.ast->right, p.nextTemp);
+    linearize(p, p.ast->left);
+    pushOperator(p, ASSIGN_OP);
+    p.counters.shared += before - countOperators(p.postfix);
+    if (p.cse == CSE_BLOCK) {
+        int target = leafSymbol(p, p.ast->left);
+        if (target >= (int)p.versions.size()) p.versions.resize(target + 1, 0);
+        p.versions[target]++;
+    }
+}
+
+//The generateIC() function generates intermediate code from the postfix expression into p.ir. Operands are pushed on a stack of ids, and every operator pops its operands and pushes a new temporary. Everything is decided by the opcode, so no strings are compared.
+void generateIC(Parser& p, const vector<PostfixItem>& postfix) {
+    p.ir.clear();
+    vector<int>& s = p.operands;
+    s.clear();
+    int temps = p.tempBase;
+    for (size_t i = 0; i < postfix.size(); ++i) {
+        const PostfixItem& item = postfix[i];
+        switch (item.op) {
+        //Operands (and temporaries reused by --cse) just put their id onto the stack for later operations.
+            case IDENT:
+            case INT_LIT:
+            case TEMP_REF:
+                s.push_back(item.operand);
+                break;
+        //An assignment takes two values from the stack—the variable (pushed last) and the value below it.
+            case ASSIGN_OP: {
+                int target = s.back(); s.pop_back();
+                int value = s.back(); s.pop_back();
+                Quad q = {ASSIGN_OP, value, NO_OPERAND, target};
+                p.ir.push_back(q);
+                break;
+            }
+        //Unary minus and logical NOT pop one value and put the result in a new temporary.
+            case UNARY_MINUS:
+            case BNOT_OP: {
+                int a = s.back(); s.pop_back();
+                Quad q = {item.op, a, NO_OPERAND, tempOperand(temps++)};
+                p.ir.push_back(q);
+                s.push_back(q.result);
+                break;
+            }
+        //Binary operators pop two values from the stack and store the result in a new temporary.
+            default: {
+                int b = s.back(); s.pop_back();
+                int a = s.back(); s.pop_back();
+                Quad q = {item.op, a, b, tempOperand(temps++)};
+                p.ir.push_back(q);
+                s.push_back(q.result);
+                break;
+            }
+        }
+    }
+#ifdef COLLECT_STATS
+    p.stats.temps += temps - p.tempBase;
+#endif
+}
+
+//printOperand() prints a symbol's name or a temporary's generated name.
+void printOperand(Parser& p, int operand) {
+    if (isTemp(operand)) {
+        char buf[8];
+        p.out.write(buf, tempName(-operand - 1, buf));
+    } else {
+        p.out << p.symbols.names[operand];
+    }
+}
+
+/*
+printIC() prints the intermediate code the way the analyzer has always shown it: it walks the postfix expression again and shows every
+push, top and pop of the evaluation stack around each instruction in p.ir.
+*/
+void printIC(Parser& p, const vector<PostfixItem>& postfix) {
+    p.out << "\n-----------------------INTERMEDIATE CODE GENERATOR-----------------------\n";
+    size_t next = 0;
+    for (size_t i = 0; i < postfix.size(); ++i) {
+        if (postfix[i].operand != NO_OPERAND) {
+            p.out << "push ";
+            printOperand(p, postfix[i].operand);
+            p.out << '\n';
+            continue;
+        }
+        const Quad& q = p.ir[next++];
+    //This prints the top two values being removed from the stack (the variable first, then its value) and shows the assignment instruction being created from them.
+        if (q.op == ASSIGN_OP) {
+            p.out << "top "; printOperand(p, q.result); p.out << "\npop()\n";
+            p.out << "top "; printOperand(p, q.arg1); p.out << "\npop()\n";
+            p.out << "assign "; printOperand(p, q.arg1); p.out << ", "; printOperand(p, q.result); p.out << '\n';
+    //This prints the top value being popped from the stack, the unary (bnot or uminus) instruction, and the push of its temporary.
+        } else if (q.arg2 == NO_OPERAND) {
+            p.out << "top "; printOperand(p, q.arg1); p.out << "\npop()\n";
+            p.out << opTable[q.op].mnemonic << ", "; printOperand(p, q.arg1); p.out << ", "; printOperand(p, q.result); p.out << '\n';
+            p.out << "push "; printOperand(p, q.result); p.out << '\n';
+    //This prints the operation steps: shows which operands are popped from the stack, prints the instruction using its mnemonic, and pushes the result temporary back onto the stack.
+        } else {
+            p.out << opTable[q.op].symbol << "\ntop ";
+            printOperand(p, q.arg2); p.out << "\npop()\ntop "; printOperand(p, q.arg1); p.out << "\npop()\n";
+            p.out << opTable[q.op].mnemonic << ", "; printOperand(p, q.arg1); p.out << ", "; printOperand(p, q.arg2);
+            p.out << ", "; printOperand(p, q.result); p.out << '\n';
+            p.out << "push "; printOperand(p, q.result); p.out << '\n';
+        }
+    }
+}
+
+//putOperand() writes an operand of an 'I' record as a length-prefixed name.
+void putOperand(Parser& p, int operand) {
+    if (isTemp(operand)) {
+        char buf[8];
+        p.out.putText(buf, tempName(-operand - 1, buf));
+    } else {
+        const string& name = p.symbols.names[operand];
+        p.out.putText(name.data(), name.size());
+    }
+}
+
+//emitIC() writes one 'I' record of the binary stream per instruction: the operation and its operands, the result (or the assigned variable) last.
+void emitIC(Parser& p) {
+    for (size_t i = 0; i < p.ir.size(); ++i) {
+        const Quad& q = p.ir[i];
+        p.out.putByte('I');
+        p.out.putByte((unsigned char)q.op);
+        p.out.putByte(q.arg2 == NO_OPERAND ? 2 : 3);
+        putOperand(p, q.arg1);
+        if (q.arg2 != NO_OPERAND) putOperand(p, q.arg2);
+        putOperand(p, q.result);
+    }
+}
+
+/*****************************************************/
+/*
+Evaluator (--eval)
+
+The intermediate code of every statement is compiled into one Program for a small register machine. Each distinct variable, constant and
+temporary gets a fixed register; the variable table is bound once, when the program is compiled, so running it is just a loop over
+VmInstr records that read and write registers by index. Values are 64-bit integers; comparisons and && || give 0 or 1, and a division by
+zero gives 0 and is counted.
+*/
+struct VmInstr {
+    TokenType op;
+    int dst;
+    int a;
+    int b;
+};
+
+/*
+Program holds the compiled code, the names of the variables and the register each one lives in, and initial, the register file a run
+starts from (constants already filled in). While compiling, symbolSlot maps the parser's symbol ids to registers and temporaries are kept
+as negative numbers; finishProgram() moves them behind the other registers.
+*/
+struct Program {
+    vector<VmInstr> code;
+    vector<string> variables;
+    vector<int> variableSlots;
+    vector<long long> initial;
+    vector<int> symbolSlot;
+    int temps;
+
+    Program() : temps(0) {}
+};
+
+//slotOf() gives the register of an operand, adding a register for a variable or constant the first time it is seen.
+int slotOf(Program& prog, const Parser& p, int operand) {
+    if (operand == NO_OPERAND) return 0;
+    if (isTemp(operand)) {
+        int t = -operand - 1;
+        if (t + 1 > prog.temps) prog.temps = t + 1;
+        return operand;
+    }
+    if (operand >= (int)prog.symbolSlot.size()) prog.symbolSlot.resize(operand + 1, -1);
+    if (prog.symbolSlot[operand] < 0) {
+        const string& name = p.symbols.names[operand];
+        prog.symbolSlot[operand] = (int)prog.initial.size();
+        if (isdigit((unsigned char)name[0]) || name[0] == '-') {
+            prog.initial.push_back(strtoll(name.c_str(), NULL, 10));
+        } else {
+            prog.variables.push_back(name);
+            prog.variableSlots.push_back((int)prog.initial.size());
+            prog.initial.push_back(0);
+        }
+    }
+    return prog.symbolSlot[operand];
+}
+
+//compileStatement() adds the intermediate code of the statement that was just analyzed to the program.
+void compileStatement(Program& prog, Parser& p) {
+    generateIC(p, p.postfix);
+    for (size_t i = 0; i < p.ir.size(); ++i) {
+        const Quad& q = p.ir[i];
+        VmInstr in = {q.op, slotOf(prog, p, q.result), slotOf(prog, p, q.arg1), slotOf(prog, p, q.arg2)};
+        prog.code.push_back(in);
+    }
+}
+
+//finishProgram() gives the temporaries their registers after the variables and constants, once all statements are compiled.
+void finishProgram(Program& prog) {
+    int base = (int)prog.initial.size();
+    for (size_t i = 0; i < prog.code.size(); ++i) {
+        VmInstr& in = prog.code[i];
+        if (in.dst < 0) in.dst = base - in.dst - 1;
+        if (in.a < 0) in.a = base - in.a - 1;
+        if (in.b < 0) in.b = base - in.b - 1;
+    }
+    prog.initial.resize(base + prog.temps, 0);
+}
+
+//runProgram() executes the program once on the register file regs and returns how many divisions by zero it met.
+long long runProgram(const Program& prog, long long* regs) {
+    long long divisionsByZero = 0;
+    const VmInstr* end = prog.code.data() + prog.code.size();
+    for (const VmInstr* in = prog.code.data(); in != end; ++in) {
+        long long a = regs[in->a];
+        long long b = regs[in->b];
+        long long r;
+        switch (in->op) {
+            case ASSIGN_OP: r = a; break;
+            case ADD_OP: r = (long long)((unsigned long long)a + (unsigned long long)b); break;
+            case SUB_OP: r = (long long)((unsigned long long)a - (unsigned long long)b); break;
+            case MULT_OP: r = (long long)((unsigned long long)a * (unsigned long long)b); break;
+            case DIV_OP:
+                if (b == 0) {
+                    divisionsByZero++;
+                    r = 0;
+                } else {
+                    r = b == -1 ? (long long)(0ULL - (unsigned long long)a) : a / b;
+                }
+                break;
+            case UNARY_MINUS: r = (long long)(0ULL - (unsigned long long)a); break;
+            case BNOT_OP: r = !a; break;
+            case REQ_OP: r = a == b; break;
+            case RNEQ_OP: r = a != b; break;
+            case RLT_OP: r = a < b; break;
+            case RLEQ_OP: r = a <= b; break;
+            case RGT_OP: r = a > b; break;
+            case RGEQ_OP: r = a >= b; break;
+            case BAND_OP: r = a && b; break;
+            case BOR_OP: r = a || b; break;
+            default: r = 0; break;
+        }
+        regs[in->dst] = r;
+    }
+    return divisionsByZero;
+}
+
+/*
+evaluateBatch() runs the program over count environments. envs holds one row per environment with a value for every variable, in the
+order of prog.variables; each row is read before the run and receives the variables' final values after it. It returns the number of
+divisions by zero.
+*/
+long long evaluateBatch(const Program& prog, long long* envs, size_t count) {
+    vector<long long> regs(prog.initial);
+    size_t vars = prog.variableSlots.size();
+    const int* slots = prog.variableSlots.data();
+    long long divisionsByZero = 0;
+    for (size_t e = 0; e < count; ++e) {
+        long long* env = envs + e * vars;
+        for (size_t v = 0; v < vars; ++v) regs[slots[v]] = env[v];
+        divisionsByZero += runProgram(prog, regs.data());
+        for (size_t v = 0; v < vars; ++v) env[v] = regs[slots[v]];
+    }
+    return divisionsByZero;
+}
+
+/*
+Columnar evaluation. Instead of running the whole program once per environment, every instruction is applied to a block of
+COLUMN_BLOCK rows at a time: each register becomes a column of COLUMN_BLOCK values, and the loops in columnOp() are simple enough for the
+compiler to vectorize (everything except division). Constants are filled into their columns once, before the first block.
+*/
+#define COLUMN_BLOCK 256
+
+void columnOp(TokenType op, long long* d, const long long* a, const long long* b, size_t n, long long& divisionsByZero) {
+    const unsigned long long* ua = (const unsigned long long*)a;
+    const unsigned long long* ub = (const unsigned long long*)b;
+    switch (op) {
+        case ASSIGN_OP: for (size_t i = 0; i < n; ++i) d[i] = a[i]; break;
+        case ADD_OP: for (size_t i = 0; i < n; ++i) d[i] = (long long)(ua[i] + ub[i]); break;
+        case SUB_OP: for (size_t i = 0; i < n; ++i) d[i] = (long long)(ua[i] - ub[i]); break;
+        case MULT_OP: for (size_t i = 0; i < n; ++i) d[i] = (long long)(ua[i] * ub[i]); break;
+        case DIV_OP:
+            for (size_t i = 0; i < n; ++i) {
+                if (b[i] == 0) {
+                    divisionsByZero++;
+                    d[i] = 0;
+                } else {
+                    d[i] = b[i] == -1 ? (long long)(0ULL - ua[i]) : a[i] / b[i];
+                }
+            }
+            break;
+        case UNARY_MINUS: for (size_t i = 0; i < n; ++i) d[i] = (long long)(0ULL - ua[i]); break;
+        case BNOT_OP: for (size_t i = 0; i < n; ++i) d[i] = a[i] == 0; break;
+        case REQ_OP: for (size_t i = 0; i < n; ++i) d[i] = a[i] == b[i]; break;
+        case RNEQ_OP: for (size_t i = 0; i < n; ++i) d[i] = a[i] != b[i]; break;
+        case RLT_OP: for (size_t i = 0; i < n; ++i) d[i] = a[i] < b[i]; break;
+        case RLEQ_OP: for (size_t i = 0; i < n; ++i) d[i] = a[i] <= b[i]; break;
+        case RGT_OP: for (size_t i = 0; i < n; ++i) d[i] = a[i] > b[i]; break;
+        case RGEQ_OP: for (size_t i = 0; i < n; ++i) d[i] = a[i] >= b[i]; break;
+        case BAND_OP: for (size_t i = 0; i < n; ++i) d[i] = (a[i] != 0) & (b[i] != 0); break;
+        case BOR_OP: for (size_t i = 0; i < n; ++i) d[i] = (a[i] != 0) | (b[i] != 0); break;
+        default: for (size_t i = 0; i < n; ++i) d[i] = 0; break;
+    }
+}
+
+/*
+evaluateColumns() runs the program over rows environments given as columns: columns[v] is a contiguous array of rows values for
+variable v (in the order of prog.variables), and receives the variable's final values. It returns the number of divisions by zero.
+*/
+long long evaluateColumns(const Program& prog, long long* const* columns, size_t rows) {
+    size_t registers = prog.initial.size();
+    vector<long long> regs(registers * COLUMN_BLOCK);
+    for (size_t r = 0; r < registers; ++r) {
+        for (size_t i = 0; i < COLUMN_BLOCK; ++i) regs[r * COLUMN_BLOCK + i] = prog.initial[r];
+    }
+    long long* file = regs.data();
+    size_t vars = prog.variableSlots.size();
+    long long divisionsByZero = 0;
+    for (size_t start = 0; start < rows; start += COLUMN_BLOCK) {
+        size_t n = rows - start < COLUMN_BLOCK ? rows - start : COLUMN_BLOCK;
+        for (size_t v = 0; v < vars; ++v) {
+            memcpy(file + (size_t)prog.variableSlots[v] * COLUMN_BLOCK, columns[v] + start, n * sizeof(long long));
+        }
+        for (size_t k = 0; k < prog.code.size(); ++k) {
+            const VmInstr& in = prog.code[k];
+            columnOp(in.op, file + (size_t)in.dst * COLUMN_BLOCK, file + (size_t)in.a * COLUMN_BLOCK, file + (size_t)in.b * COLUMN_BLOCK,
+                     n, divisionsByZero);
+        }
+        for (size_t v = 0; v < vars; ++v) {
+            memcpy(columns[v] + start, file + (size_t)prog.variableSlots[v] * COLUMN_BLOCK, n * sizeof(long long));
+        }
+    }
+    return divisionsByZero;
+}
+
+/*****************************************************/
+/*
+C++ backend (--emit-cpp DIR)
+
+Every statement is also written out as a small self-contained C++ function over its three-address code. The function is named after a
+64-bit FNV-1a hash of the statement's normalized form, its instructions with the variables renamed v0, v1, ... in order of first use, so
+"x = a + b" and "y = c + d" share one function, and the same statement seen in a later run finds the function it already has.
+The sources go to DIR/expr_<hash>.cpp. At the end of the run all functions that are not compiled yet are built into one shared library,
+DIR/lib_<hash>.so, and DIR/index.txt records which library holds each function, so later runs never compile them again.
+*/
+
+//NativeStatement is one statement bound to its compiled function: slots are the registers (as in Program) of its variables v0, v1, ...
+typedef long long (*NativeFunction)(long long* v);
+
+struct NativeStatement {
+    string hash;
+    NativeFunction function;
+    vector<int> slots;
+};
+
+struct NativeCode {
+    string dir;
+    map<string, string> index;
+    vector<string> pending;
+    set<string> known;
+    vector<NativeStatement> statements;
+    int reused;
+    bool writeFailed;
+};
+
+string hashText(const string& text) {
+    unsigned long long h = 14695981039346656037ULL;
+    for (size_t i = 0; i < text.size(); ++i) {
+        h = (h ^ (unsigned char)text[i]) * 1099511628211ULL;
+    }
+    char buf[17];
+    snprintf(buf, sizeof(buf), "%016llx", h);
+    return buf;
+}
+
+//loadIndex() reads DIR/index.txt, one "hash library" pair per line.
+void loadIndex(NativeCode& native) {
+    ifstream in((native.dir + "/index.txt").c_str());
+    string hash, lib;
+    while (in >> hash >> lib) {
+        native.index[hash] = lib;
+    }
+}
+
+//cppOperand() writes an operand as a C++ expression: a variable v[i], a local temporary t<k>, or a constant literal.
+string cppOperand(const Parser& p, int operand, const vector<int>& vars, int tempBase) {
+    char buf[40];
+    if (isTemp(operand)) {
+        snprintf(buf, sizeof(buf), "t%d", -operand - 1 - tempBase);
+        return buf;
+    }
+    for (size_t i = 0; i < vars.size(); ++i) {
+        if (vars[i] == operand) {
+            snprintf(buf, sizeof(buf), "v[%zu]", i);
+            return buf;
+        }
+    }
+    long long value = strtoll(p.symbols.names[operand].c_str(), NULL, 10);
+    if (value == (-9223372036854775807LL - 1)) return "(-9223372036854775807LL - 1)";
+    snprintf(buf, sizeof(buf), "(%lldLL)", value);
+    return buf;
+}
+
+/*
+emitStatement() writes the function for the statement that was just analyzed (unless it exists already) and returns its hash. vars
+receives the symbol ids of the statement's variables in the order of the function's v[] array. If the source file can't be written, the
+first such failure is reported, the hash is not queued for compiling and writeFailed is set, so buildNative() gives up instead of
+compiling a missing file.
+*/
+string emitStatement(NativeCode& native, Parser& p, vector<int>& vars) {
+    generateIC(p, p.postfix);
+    vars.clear();
+    string body;
+    for (size_t i = 0; i < p.ir.size(); ++i) {
+        const Quad& q = p.ir[i];
+        int operands[3] = {q.arg1, q.arg2, q.result};
+        for (int k = 0; k < 3; ++k) {
+            int id = operands[k];
+            if (id == NO_OPERAND || isTemp(id)) continue;
+            const string& name = p.symbols.names[id];
+            if (isdigit((unsigned char)name[0]) || name[0] == '-') continue;
+            bool seen = false;
+            for (size_t j = 0; j < vars.size(); ++j) seen = seen || vars[j] == id;
+            if (!seen) vars.push_back(id);
+        }
+        string a = cppOperand(p, q.arg1, vars, p.tempBase);
+        string b = q.arg2 == NO_OPERAND ? "" : cppOperand(p, q.arg2, vars, p.tempBase);
+        string r = cppOperand(p, q.result, vars, p.tempBase);
+        string expr;
+        switch (q.op) {
+            case ASSIGN_OP: expr = a; break;
+            case ADD_OP: expr = "(long long)((unsigned long long)" + a + " + (unsigned long long)" + b + ")"; break;
+            case SUB_OP: expr = "(long long)((unsigned long long)" + a + " - (unsigned long long)" + b + ")"; break;
+            case MULT_OP: expr = "(long long)((unsigned long long)" + a + " * (unsigned long long)" + b + ")"; break;
+            case DIV_OP: expr = "ic_div(" + a + ", " + b + ", &divisionsByZero)"; break;
+            case UNARY_MINUS: expr = "(long long)(0ULL - (unsigned long long)" + a + ")"; break;
+            case BNOT_OP: expr = "(long long)(" + a + " == 0)"; break;
+            case BAND_OP: expr = "(long long)(" + a + " != 0 && " + b + " != 0)"; break;
+            case BOR_OP: expr = "(long long)(" + a + " != 0 || " + b + " != 0)"; break;
+            default: expr = string("(long long)(") + a + " " + opTable[q.op].symbol + " " + b + ")"; break;
+        }
+        body += "    ";
+        if (isTemp(q.result)) body += "long long ";
+        body += r + " = " + expr + ";\n";
+    }
+    string hash = hashText(body);
+    if (native.index.count(hash) || native.known.count(hash)) {
+        if (native.index.count(hash) && native.known.insert(hash).second) native.reused++;
+        return hash;
+    }
+    native.known.insert(hash);
+    string path = native.dir + "/expr_" + hash + ".cpp";
+    FILE* f = fopen(path.c_str(), "w");
+    if (f == NULL) {
+        if (!native.writeFailed) fprintf(stderr, "Native: could not write %s\n", path.c_str());
+        native.writeFailed = true;
+        return hash;
+    }
+    native.pending.push_back(hash);
+    fprintf(f, "// Generated by SyntaxAnalyzer; do not edit.\n"
+               "static inline long long ic_div(long long a, long long b, long long* divisionsByZero) {\n"
+               "    if (b == 0) { ++*divisionsByZero; return 0; }\n"
+               "    return b == -1 ? (long long)(0ULL - (unsigned long long)a) : a / b;\n"
+               "}\n\n"
+               "extern \"C\" long long expr_%s(long long* v) {\n"
+               "    long long divisionsByZero = 0;\n"
+               "    (void)ic_div;\n"
+               "%s"
+               "    return divisionsByZero;\n"
+               "}\n", hash.c_str(), body.c_str());
+    fclose(f);
+    return hash;
+}
+
+//splitWords() splits $CXX at blanks, so it may name a compiler together with a wrapper or flags ("ccache g++", "g++ -march=native").
+vector<string> splitWords(const string& text) {
+    vector<string> words;
+    string word;
+    for (size_t i = 0; i <= text.size(); ++i) {
+        if (i == text.size() || isspace((unsigned char)text[i])) {
+            if (!word.empty()) words.push_back(word);
+            word.clear();
+        } else {
+            word += text[i];
+        }
+    }
+    return words;
+}
+
+/*
+runCommand() runs a program with the given arguments and waits for it; it returns true if the program exited with 0. The arguments go
+straight to execvp() with no shell in between, so a directory name with quotes, spaces or $ in it is passed as it is.
+*/
+bool runCommand(const vector<string>& words) {
+    vector<char*> argv;
+    for (size_t i = 0; i < words.size(); ++i) argv.push_back(const_cast<char*>(words[i].c_str()));
+    argv.push_back(NULL);
+    fflush(stdout);
+    fflush(stderr);
+    pid_t pid = fork();
+    if (pid < 0) return false;
+    if (pid == 0) {
+        execvp(argv[0], &argv[0]);
+        fprintf(stderr, "Native: can't run %s\n", argv[0]);
+        _exit(127);
+    }
+    int status = 0;
+    if (waitpid(pid, &status, 0) < 0) return false;
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+/*
+buildNative() compiles the new functions of this run into one library with the compiler named by $CXX (c++ by default), adds them to the
+index, and then loads every library the run needs with dlopen(). It returns false if a source file could not be written or compiling or
+loading fails.
+*/
+bool buildNative(NativeCode& native) {
+    if (native.writeFailed) return false;
+    if (!native.pending.empty()) {
+        string all;
+        for (size_t i = 0; i < native.pending.size(); ++i) all += native.pending[i];
+        string lib = "lib_" + hashText(all) + ".so";
+        const char* cxx = getenv("CXX");
+        vector<string> words = splitWords(cxx != NULL && *cxx != '\0' ? cxx : "c++");
+        words.push_back("-O2");
+        words.push_back("-shared");
+        words.push_back("-fPIC");
+        words.push_back("-o");
+        words.push_back(native.dir + "/" + lib);
+        for (size_t i = 0; i < native.pending.size(); ++i) {
+            words.push_back(native.dir + "/expr_" + native.pending[i] + ".cpp");
+        }
+        if (!runCommand(words)) {
+            fprintf(stderr, "Native: compiling %s failed\n", lib.c_str());
+            return false;
+        }
+        FILE* f = fopen((native.dir + "/index.txt").c_str(), "a");
+        for (size_t i = 0; i < native.pending.size(); ++i) {
+            native.index[native.pending[i]] = lib;
+            if (f != NULL) fprintf(f, "%s %s\n", native.pending[i].c_str(), lib.c_str());
+        }
+        if (f != NULL) fclose(f);
+    }
+    map<string, void*> handles;
+    for (size_t i = 0; i < native.statements.size(); ++i) {
+        NativeStatement& st = native.statements[i];
+        const string& lib = native.index[st.hash];
+        if (!handles.count(lib)) {
+            handles[lib] = dlopen((native.dir + "/" + lib).c_str(), RTLD_NOW | RTLD_LOCAL);
+            if (handles[lib] == NULL) {
+                fprintf(stderr, "Native: %s\n", dlerror());
+                return false;
+            }
+        }
+        st.function = (NativeFunction)dlsym(handles[lib], ("expr_" + st.hash).c_str());
+        if (st.function == NULL) {
+            fprintf(stderr, "Native: expr_%s is missing from %s\n", st.hash.c_str(), lib.c_str());
+            return false;
+        }
+    }
+    fprintf(stderr, "Native: %zu statements, %zu distinct functions, %d reused from %s, %zu compiled\n", native.statements.size(),
+            native.known.size(), native.reused, native.dir.c_str(), native.pending.size());
+    return true;
+}
+
+//addNativeStatement() emits the statement that was just analyzed and remembers which registers of prog its variables live in.
+void addNativeStatement(NativeCode& native, Program& prog, Parser& p) {
+    vector<int> vars;
+    NativeStatement st;
+    st.hash = emitStatement(native, p, vars);
+    st.function = NULL;
+    for (size_t i = 0; i < vars.size(); ++i) {
+        st.slots.push_back(slotOf(prog, p, vars[i]));
+    }
+    native.statements.push_back(st);
+}
+
+//evaluateNative() is evaluateBatch() with the compiled functions: each statement copies its variables in and out of a small array.
+long long evaluateNative(const Program& prog, const NativeCode& native, long long* envs, size_t count) {
+    vector<long long> regs(prog.initial);
+    size_t widest = 1;
+    for (size_t k = 0; k < native.statements.size(); ++k) {
+        if (native.statements[k].slots.size() > widest) widest = native.statements[k].slots.size();
+    }
+    vector<long long> local(widest);
+    size_t vars = prog.variableSlots.size();
+    const int* slots = prog.variableSlots.data();
+    long long divisionsByZero = 0;
+    for (size_t e = 0; e < count; ++e) {
+        long long* env = envs + e * vars;
+        for (size_t v = 0; v < vars; ++v) regs[slots[v]] = env[v];
+        for (size_t k = 0; k < native.statements.size(); ++k) {
+            const NativeStatement& st = native.statements[k];
+            size_t n = st.slots.size();
+            for (size_t i = 0; i < n; ++i) local[i] = regs[st.slots[i]];
+            divisionsByZero += st.function(local.data());
+            for (size_t i = 0; i < n; ++i) regs[st.slots[i]] = local[i];
+        }
+        for (size_t v = 0; v < vars; ++v) env[v] = regs[slots[v]];
+    }
+    return divisionsByZero;
+}
+
+/*
+benchmarkEval() is the --eval N benchmark: it evaluates the program over N pseudo-random environments (values -100..100), in batches
+of EVAL_BATCH, and reports the speed and a checksum of the results on stderr. Only the evaluation itself is timed. With columnar set the
+same environments are stored as columns and run through evaluateColumns(), and with native the compiled functions are used, so every way
+gives the same checksum.
+*/
+#define EVAL_BATCH 4096
+
+void benchmarkEval(const Program& prog, long long environments, bool columnar, const NativeCode* native) {
+    size_t vars = prog.variables.size();
+    vector<long long> envs(EVAL_BATCH * (vars > 0 ? vars : 1));
+    vector<long long> columnData(envs.size());
+    vector<long long*> columns(vars);
+    for (size_t v = 0; v < vars; ++v) columns[v] = columnData.data() + v * EVAL_BATCH;
+    unsigned long long seed = 88172645463325252ULL;
+    unsigned long long checksum = 0;
+    long long divisionsByZero = 0;
+    double seconds = 0;
+    for (long long done = 0; done < environments; done += EVAL_BATCH) {
+        size_t count = (size_t)(environments - done < EVAL_BATCH ? environments - done : EVAL_BATCH);
+        for (size_t i = 0; i < count * vars; ++i) {
+            seed ^= seed << 13;
+            seed ^= seed >> 7;
+            seed ^= seed << 17;
+            envs[i] = (long long)(seed % 201) - 100;
+        }
+        if (columnar) {
+            for (size_t e = 0; e < count; ++e) {
+                for (size_t v = 0; v < vars; ++v) columns[v][e] = envs[e * vars + v];
+            }
+        }
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        if (native != NULL) {
+            divisionsByZero += evaluateNative(prog, *native, envs.data(), count);
+        } else if (columnar) {
+            divisionsByZero += evaluateColumns(prog, columns.data(), count);
+        } else {
+            divisionsByZero += evaluateBatch(prog, envs.data(), count);
+        }
+        seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        if (columnar) {
+            for (size_t e = 0; e < count; ++e) {
+                for (size_t v = 0; v < vars; ++v) envs[e * vars + v] = columns[v][e];
+            }
+        }
+        for (size_t i = 0; i < count * vars; ++i) {
+            checksum = (checksum ^ (unsigned long long)envs[i]) * 1099511628211ULL;
+        }
+    }
+    fprintf(stderr, "Eval (%s): %zu instructions, %zu variables, %lld environments in %.3f s (%.0f evaluations/second), "
+            "divisions by zero=%lld checksum=%016llx\n", native != NULL ? "native" : columnar ? "columns" : "rows", prog.code.size(), vars, environments, seconds,
+            seconds > 0 ? environments / seconds : 0.0, divisionsByZero, checksum);
+}
+
+/*
+tokenize() breaks the input line into tokens with the shared lexer in its expression dialect. Tokens only record where their lexeme starts
+and how long it is, and the result vector is reused from line to line so nothing is allocated per token. An UNKNOWN token is a character
+that starts no token, which is a lexical error.
+*/
+void tokenize(const string& line, vector<Token>& result) {
+    result.clear();
+    Lexer lx;
+    LexToken tok;
+    lexer_init(&lx, line.data(), line.length(), LEX_EXPR);
+    while (lexer_next(&lx, &tok) != END_OF_FILE) {
+        if (tok.code == UNKNOWN && tok.size == 1) {
+            throw AnalysisError{string("lexical error: invalid character '") + line[tok.offset] + "'", (unsigned)tok.offset};
+        }
+    //A longer UNKNOWN is a number with a dot but no digits after it (3.) or a name with an unfinished index (a[3).
+        if (tok.code == UNKNOWN) {
+            throw AnalysisError{"lexical error: invalid token '" + line.substr(tok.offset, tok.size) + "'", (unsigned)tok.offset};
+        }
+        result.push_back(Token(tok.code, (unsigned)tok.offset, (unsigned)tok.size));
+    }
+    //This code adds an end_of_file token to signal the end of the input.
+    result.push_back(Token(END_OF_FILE, line.length(), 0));
+}
+//useExprCache() is true when --expr-cache is on; in a --cse block a statement also depends on the ones before it, so it is never cached.
+bool useExprCache(const Parser& p) {
+    return p.exprCache.budget > 0 && p.cse != CSE_BLOCK;
+}
+
+//exprKey() builds the cache key of the tokenized statement: every token's type, followed by its text for names and constants.
+void exprKey(Parser& p) {
+    string& key = p.exprCache.key;
+    key.clear();
+    for (size_t i = 0; i < p.tokens.size(); ++i) {
+        const Token& tok = p.tokens[i];
+        key += (char)tok.type;
+        if (tok.type == IDENT || tok.type == INT_LIT) {
+            key.append(p.source + tok.offset, tok.length);
+            key += '\0';
+        }
+    }
+}
+
+//findExpr() looks the statement up and, if it is there, makes it the most recently used entry.
+const ExprEntry* findExpr(Parser& p) {
+    exprKey(p);
+    ExprCache& c = p.exprCache;
+    unordered_map<string, list<ExprEntry>::iterator>::iterator it = c.index.find(c.key);
+    if (it == c.index.end()) {
+        p.counters.exprMisses++;
+        return NULL;
+    }
+    p.counters.exprHits++;
+    c.entries.splice(c.entries.begin(), c.entries, it->second);
+    return &*it->second;
+}
+
+//addExpr() adds an entry for the key built by findExpr() (or the one already in e.key), then drops the oldest entries over the budget.
+void addExpr(Parser& p, ExprEntry& e) {
+    ExprCache& c = p.exprCache;
+    if (e.key.empty()) e.key = c.key;
+    e.bytes = sizeof(ExprEntry) + 2 * e.key.size() + e.trace.size() + e.postfix.size() * sizeof(PostfixItem) + e.ir.size() * sizeof(Quad);
+    if (e.bytes > c.budget || c.index.count(e.key)) return;
+    c.entries.push_front(ExprEntry());
+    c.entries.front().key.swap(e.key);
+    c.entries.front().trace.swap(e.trace);
+    c.entries.front().postfix.swap(e.postfix);
+    c.entries.front().ir.swap(e.ir);
+    c.entries.front().folded = e.folded;
+    c.entries.front().simplified = e.simplified;
+    c.entries.front().eliminated = e.eliminated;
+    c.entries.front().shared = e.shared;
+    c.entries.front().bytes = e.bytes;
+    c.index[c.entries.front().key] = c.entries.begin();
+    c.bytes += e.bytes;
+    while (c.bytes > c.budget) {
+        ExprEntry& last = c.entries.back();
+        c.bytes -= last.bytes;
+        c.index.erase(last.key);
+        c.entries.pop_back();
+        p.counters.exprEvictions++;
+    }
+}
+
+/*
+storeExpr() caches the statement that was just analyzed; traceStart is where its parse trace begins in p.out, before the counters from before it.
+The summary never generates intermediate code, so there p.ir belongs to no statement in particular and is not stored.
+*/
+void storeExpr(Parser& p, size_t traceStart, const Counters& before) {
+    ExprEntry e;
+    if (p.mode == OUTPUT_FULL) e.trace.assign(p.out.data, traceStart, string::npos);
+    e.postfix = p.postfix;
+    if (p.mode != OUTPUT_SUMMARY) e.ir = p.ir;
+    e.folded = p.counters.folded - before.folded;
+    e.simplified = p.counters.simplified - before.simplified;
+    e.eliminated = p.counters.eliminated - before.eliminated;
+    e.shared = p.counters.shared - before.shared;
+    addExpr(p, e);
+}
+
+//replayExpr() puts a cached statement's results where assign() and the passes would have left them.
+void replayExpr(Parser& p, const ExprEntry& e) {
+    p.out.write(e.trace.data(), e.trace.size());
+    p.postfix = e.postfix;
+    p.ir = e.ir;
+    p.counters.folded += e.folded;
+    p.counters.simplified += e.simplified;
+    p.counters.eliminated += e.eliminated;
+    p.counters.shared += e.shared;
+}
+
+//putAssignmentNumber() writes the assignment number and remembers where, so --incremental can store the output without it.
+void putAssignmentNumber(Parser& p, int assignmentNumber) {
+    p.numbers.push_back(p.out.data.size());
+    if (p.mode == OUTPUT_BINARY) p.out.putU32((unsigned)assignmentNumber);
+    else p.out << assignmentNumber;
+}
+
+//timedAssign() is assign() for --parse-stats: it also times the parse and counts the operands (all but the assigned variable) and the rules entered.
+void timedAssign(Parser& p) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    assign(p);
+    p.counters.parseNanos += chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+    p.counters.operands += (long long)p.postfix.size() - countOperators(p.postfix) - 1;
+    p.counters.ruleCalls += p.ruleId - 1;
+}
+
+/*
+processStatement() runs one statement through the whole pipeline (tokenize, parse, postfix, intermediate code) and writes its trace into p.out.
+It returns false if the statement has a lexical or syntax error; the output up to the error stays in p.out and the error is described in
+p.diagnostic. Nothing else is left behind, so the next statement starts cleanly: an error only skips the rest of its own statement.
+*/
+bool processStatement(Parser& p, const Statement& stmt, int assignmentNumber) {
+    const string& line = stmt.text;
+//These lines print the current line being processed, mark the start of a new assignment, tokenize the line into tokens, reset parsing state, and clear the postfix expression list to prepare for the next analysis.
+    bool trace = p.mode == OUTPUT_FULL;
+    bool cached = false;
+    size_t traceStart = 0;
+    Counters before = Counters();
+    if (trace) {
+        p.out << "\nProcessing line: " << line << "\n";
+        p.out << "\n-----------------------START ASSIGNMENT ";
+        putAssignmentNumber(p, assignmentNumber);
+        p.out << "-----------------------\n";
+    }
+    try {
+        p.source = line.c_str();
+        {
+            PhaseTimer timer(p.stats, PHASE_TOKENIZE);
+            tokenize(line, p.tokens);
+        }
+#ifdef COLLECT_STATS
+        p.stats.statements++;
+        p.stats.tokens += (long long)p.tokens.size() - 1;
+#endif
+        p.currentIndex = 0;
+        p.ruleId = 1;
+        p.depth = 0;
+        p.callDepth = 0;
+        p.postfix.clear();
+        p.ast = NULL;
+//The tree and the --cse table are thrown away for every statement, except inside a --cse block where later statements share them.
+        if (p.cse != CSE_BLOCK || stmt.startsLine) {
+            p.arena.reset();
+            p.dag.clear();
+            p.versions.clear();
+            p.tempBase = 0;
+            p.nextTemp = 0;
+        }
+//In binary mode the statement record and its token records come first, before the parse.
+        if (p.mode == OUTPUT_BINARY) {
+            p.out.putByte('S');
+            putAssignmentNumber(p, assignmentNumber);
+            p.out.putU32((unsigned)line.size());
+            p.out.write(line.data(), line.size());
+            for (size_t i = 0; i < p.tokens.size(); ++i) {
+                p.out.putByte('T');
+                p.out.putByte((unsigned char)p.tokens[i].type);
+                p.out.putU32(p.tokens[i].offset);
+                p.out.putU32(p.tokens[i].length);
+            }
+        }
+//This prints a header to indicate the start of parsing, then begins parsing the assignment expression using the assign() function.
+        if (trace) p.out << "-----------------------PARSING TREE-----------------------\n";
+        const ExprEntry* hit = useExprCache(p) ? findExpr(p) : NULL;
+        if (hit != NULL) {
+            replayExpr(p, *hit);
+            cached = true;
+        } else {
+            traceStart = p.out.data.size();
+            before = p.counters;
+            {
+                PhaseTimer timer(p.stats, PHASE_PARSE);
+                if (p.parseStats) {
+                    timedAssign(p);
+                } else {
+                    assign(p);
+                }
+            }
+            if (p.fold) {
+                PhaseTimer timer(p.stats, PHASE_FOLD);
+                foldStatement(p);
+            }
+            if (p.cse != CSE_OFF) {
+                PhaseTimer timer(p.stats, PHASE_CSE);
+                shareStatement(p);
+            }
+        }
+    } catch (const AnalysisError& e) {
+        p.counters.errors++;
+        p.diagnostic.line = stmt.line;
+        p.diagnostic.column = stmt.column + (int)e.offset + 1;
+        p.diagnostic.message = e.message;
+        p.diagnostic.outputEnd = p.out.data.size();
+        return false;
+    }
+//The summary only needs the totals: every postfix item that is not an operand becomes one instruction.
+    if (p.mode == OUTPUT_SUMMARY) {
+        p.counters.statements++;
+        p.counters.tokens += (long long)p.tokens.size() - 1;
+        p.counters.postfixItems += (long long)p.postfix.size();
+        p.counters.instructions += countOperators(p.postfix);
+        if (!cached && useExprCache(p)) storeExpr(p, traceStart, before);
+        return true;
+    }
+//This calls the intermediate code generator to simulate execution of the postfix expression (a cached statement already has it).
+    if (!cached) {
+        {
+            PhaseTimer timer(p.stats, PHASE_IC);
+            generateIC(p, p.postfix);
+        }
+        if (useExprCache(p)) storeExpr(p, traceStart, before);
+    }
+//From here on the statement is only printed.
+    PhaseTimer timer(p.stats, PHASE_FORMAT);
+    if (!trace) {
+        emitIC(p);
+        return true;
+    }
+//This prints a header, then outputs the entire postfix expression generated during parsing by iterating through the postfix vector.
+    p.out << "\n-----------------------POSTFIX EXPRESSION-----------------------\n";
+    for (size_t i = 0; i < p.postfix.size(); ++i) {
+        const PostfixItem& item = p.postfix[i];
+        if (item.operand != NO_OPERAND) printOperand(p, item.operand);
+        else p.out << opTable[item.op].symbol;
+        p.out << " ";
+    }
+    p.out << "\n";
+//This prints the intermediate code, then prints an end marker for the assignment.
+    printIC(p, p.postfix);
+    p.out << "\n-----------------------END Assignment ";
+    putAssignmentNumber(p, assignmentNumber);
+    p.out << "-----------------------\n";
+    return true;
+}
+
+//writeOutput() moves everything the parser has printed so far to stdout and empties its buffer.
+void writeOutput(Parser& p) {
+    PhaseTimer timer(p.stats, PHASE_WRITE);
+#ifdef COLLECT_STATS
+    p.stats.outputBytes += (long long)p.out.data.size();
+#endif
+    fwrite(p.out.data.data(), 1, p.out.data.size(), stdout);
+    p.out.clear();
+    p.numbers.clear();
+}
+
+//The sequential run hands its buffer to stdout once it holds at least OUTPUT_FLUSH_SIZE bytes instead of after every statement.
+#define OUTPUT_FLUSH_SIZE (64 * 1024)
+
+//SummaryTotals adds up the counters of every parser used in the run, the same way ArenaTotals does for the arena.
+struct SummaryTotals {
+    mutex lock;
+    Counters counters;
+    PhaseStats stats;
+};
+
+SummaryTotals summaryTotals;
+
+void addCounters(const Counters& c) {
+    lock_guard<mutex> guard(summaryTotals.lock);
+    summaryTotals.counters.statements += c.statements;
+    summaryTotals.counters.tokens += c.tokens;
+    summaryTotals.counters.postfixItems += c.postfixItems;
+    summaryTotals.counters.instructions += c.instructions;
+    summaryTotals.counters.errors += c.errors;
+    summaryTotals.counters.folded += c.folded;
+    summaryTotals.counters.simplified += c.simplified;
+    summaryTotals.counters.eliminated += c.eliminated;
+    summaryTotals.counters.shared += c.shared;
+    summaryTotals.counters.exprHits += c.exprHits;
+    summaryTotals.counters.exprMisses += c.exprMisses;
+    summaryTotals.counters.exprEvictions += c.exprEvictions;
+    summaryTotals.counters.operands += c.operands;
+    summaryTotals.counters.ruleCalls += c.ruleCalls;
+    summaryTotals.counters.parseNanos += c.parseNanos;
+    if (c.maxCallDepth > summaryTotals.counters.maxCallDepth) summaryTotals.counters.maxCallDepth = c.maxCallDepth;
+}
+
+//addPhaseStats() adds one parser's PhaseStats to the totals; with --jobs the phase times of all workers are added up.
+void addPhaseStats(const PhaseStats& s) {
+    lock_guard<mutex> guard(summaryTotals.lock);
+    PhaseStats& t = summaryTotals.stats;
+    for (int i = 0; i < PHASE_COUNT; ++i) t.nanos[i] += s.nanos[i];
+    t.statements += s.statements;
+    t.tokens += s.tokens;
+    t.temps += s.temps;
+    t.nodeBytes += s.nodeBytes;
+    t.outputBytes += s.outputBytes;
+    if (s.maxNesting > t.maxNesting) t.maxNesting = s.maxNesting;
+}
+
+//printSummary() writes the totals that --output summary prints instead of the trace.
+void printSummary() {
+    const Counters& c = summaryTotals.counters;
+    printf("Statements =\t%lld\nTokens =\t%lld\nPostfix items =\t%lld\nInstructions =\t%lld\nErrors =\t%lld\n",
+           c.statements, c.tokens, c.postfixItems, c.instructions, c.errors);
+}
+
+/*
+readStatements() splits one input line into its statements. A line without ';' is a single statement, exactly as written; otherwise
+every piece between the ';' is one, and blank pieces (such as the one after a trailing ';') are skipped. The line is moved, not copied,
+in the common case.
+*/
+void readStatements(string& line, int lineNumber, vector<Statement>& result) {
+    size_t semi = line.find(';');
+    if (semi == string::npos) {
+        result.push_back(Statement());
+        result.back().text.swap(line);
+        result.back().line = lineNumber;
+        result.back().column = 0;
+        result.back().startsLine = true;
+        return;
+    }
+    size_t start = 0;
+    bool first = true;
+    for (;;) {
+        size_t end = semi == string::npos ? line.size() : semi;
+        if (line.find_first_not_of(" \t\r\v\f", start) < end) {
+            result.push_back(Statement());
+            result.back().text.assign(line, start, end - start);
+            result.back().line = lineNumber;
+            result.back().column = (int)start;
+            result.back().startsLine = first;
+            first = false;
+        }
+        if (semi == string::npos) break;
+        start = semi + 1;
+        semi = line.find(';', start);
+    }
+}
+
+/*
+StatementReader is the --stream input: it reads the file through one fixed buffer of STREAM_BUFFER bytes and hands out one statement
+at a time, split the same way as readStatements() does, so no line is ever held in memory as a whole, only the statement being analyzed.
+maxLength (0 for no limit) caps that too: the rest of a longer statement is skipped up to the next ';' or end of line and tooLong is set
+instead.
+*/
+#define STREAM_BUFFER (64 * 1024)
+#define STREAM_SYMBOLS (64 * 1024)
+
+struct StatementReader {
+    FILE* in;
+    vector<char> buffer;
+    size_t pos;
+    size_t end;
+    size_t maxLength;
+    int line;
+    int column;
+    bool lineHasSemicolon;
+    bool firstInLine;
+    bool tooLong;
+
+    StatementReader(FILE* f, size_t limit) : in(f), buffer(STREAM_BUFFER), pos(0), end(0), maxLength(limit), line(1), column(0),
+                                             lineHasSemicolon(false), firstInLine(true), tooLong(false) {}
+
+    int get() {
+        if (pos == end) {
+            end = fread(buffer.data(), 1, buffer.size(), in);
+            pos = 0;
+            if (end == 0) return EOF;
+        }
+        return (unsigned char)buffer[pos++];
+    }
+
+//next() fills st with the next statement and returns false at the end of the input.
+    bool next(Statement& st) {
+        for (;;) {
+            st.text.clear();
+            tooLong = false;
+            st.line = line;
+            st.column = column;
+            st.startsLine = firstInLine;
+            int c;
+            while ((c = get()) != EOF && c != '\n' && c != ';') {
+                column++;
+                if (maxLength == 0 || st.text.size() < maxLength) st.text += (char)c;
+                else tooLong = true;
+            }
+            bool blank = !tooLong && st.text.find_first_not_of(" \t\r\v\f") == string::npos;
+//A piece ended by ';' counts unless it is blank; a line without any ';' is one statement as it is, unless it is empty.
+            bool keep;
+            if (c == ';') {
+                column++;
+                lineHasSemicolon = true;
+                keep = !blank;
+                if (keep) firstInLine = false;
+            } else {
+                if (c == EOF && st.column == 0 && st.text.empty() && !tooLong) return false;
+                keep = lineHasSemicolon ? !blank : !st.text.empty() || tooLong;
+                line++;
+                column = 0;
+                lineHasSemicolon = false;
+                firstInLine = true;
+            }
+            if (keep) return true;
+            if (c == EOF) return false;
+        }
+    }
+};
+
+//nextStatement() is StatementReader::next() counted as the read phase.
+bool nextStatement(StatementReader& reader, Statement& stmt, PhaseStats& stats) {
+    PhaseTimer timer(stats, PHASE_READ);
+    return reader.next(stmt);
+}
+
+/*
+ErrorLog prints diagnostics to stderr as "file:line:column: message" and counts them. Once maxErrors have been reported (0 means
+no limit) it prints a last note and full() tells the caller to stop reading the input.
+*/
+struct ErrorLog {
+    const char* path;
+    int maxErrors;
+    int count;
+
+    void report(const Diagnostic& d) {
+        fprintf(stderr, "%s:%d:%d: %s\n", path, d.line, d.column, d.message.c_str());
+        count++;
+        if (full()) fprintf(stderr, "%s: too many errors (%d), stopping\n", path, count);
+    }
+    bool full() const {
+        return maxErrors > 0 && count >= maxErrors;
+    }
+};
+
+//printFoldStats() reports on stderr what the --fold pass saved.
+void printFoldStats() {
+    const Counters& c = summaryTotals.counters;
+    fprintf(stderr, "Fold: constant operations folded=%lld identities simplified=%lld instructions eliminated=%lld\n",
+            c.folded, c.simplified, c.eliminated);
+}
+
+//printCseStats() reports on stderr how many instructions --cse saved.
+void printCseStats() {
+    const Counters& c = summaryTotals.counters;
+    fprintf(stderr, "CSE: instructions eliminated=%lld\n", c.shared);
+}
+
+void printExprCacheStats() {
+    const Counters& c = summaryTotals.counters;
+    long long lookups = c.exprHits + c.exprMisses;
+    fprintf(stderr, "Expression cache: hits=%lld misses=%lld (%.1f%% hit) evictions=%lld\n", c.exprHits, c.exprMisses,
+            lookups > 0 ? 100.0 * c.exprHits / lookups : 0.0, c.exprEvictions);
+}
+
+static const char* const parserNames[] = {"recursive", "pratt", "stack"};
+
+//printParseStats() reports on stderr, for --parse-stats, how many rule calls each operand took, the deepest call chain and the parse time.
+void printParseStats(ParserKind parser) {
+    const Counters& c = summaryTotals.counters;
+    double seconds = c.parseNanos / 1e9;
+    fprintf(stderr, "Parse (%s): %lld operands, %lld rule calls (%.2f per operand), deepest call chain %lld, %.3f s (%.0f operands/second)\n",
+            parserNames[parser], c.operands, c.ruleCalls, c.operands > 0 ? (double)c.ruleCalls / c.operands : 0.0,
+            c.maxCallDepth, seconds, seconds > 0 ? c.operands / seconds : 0.0);
+}
+
+//writeBinaryHeader() starts the binary stream with its magic and version.
+void writeBinaryHeader() {
+    unsigned version = BINARY_VERSION;
+    fwrite("SYNB", 1, 4, stdout);
+    fwrite(&version, sizeof(version), 1, stdout);
+}
+
+//ArenaTotals adds up the arena counters of every parser used in the run, so --arena-stats reports the same numbers with or without --jobs.
+struct ArenaTotals {
+    mutex lock;
+    size_t allocations;
+    size_t peakBytes;
+    size_t bytesReserved;
+    size_t blockCount;
+    size_t blockSize;
+};
+
+ArenaTotals arenaTotals;
+
+void addArenaStats(const Arena& arena) {
+    lock_guard<mutex> guard(arenaTotals.lock);
+    arenaTotals.allocations += arena.allocations;
+    arenaTotals.bytesReserved += arena.bytesReserved;
+    arenaTotals.blockCount += arena.blockCount;
+    if (arena.peakBytes > arenaTotals.peakBytes) arenaTotals.peakBytes = arena.peakBytes;
+}
+
+//printArenaStats() reports how much of the tree arena the run needed, to help pick a block size with --arena-block.
+void printArenaStats(int statements) {
+    fprintf(stderr, "Arena: statements=%d allocations=%zu peak=%zu bytes reserved=%zu bytes blocks=%zu block size=%zu bytes\n",
+            statements, arenaTotals.allocations, arenaTotals.peakBytes, arenaTotals.bytesReserved, arenaTotals.blockCount,
+            arenaTotals.blockSize);
+}
+
+/*
+printStatsJson() writes what --stats collected as one JSON object on stderr: the wall time of the whole run, the seconds spent in every
+phase (added up over the workers with --jobs), the rates, and the counters. ruleCalls and the deepest call chain are always kept; the rest
+needs a build with -DCOLLECT_STATS.
+*/
+void printStatsJson(double wallSeconds, int jobs, ParserKind parser) {
+    const PhaseStats& t = summaryTotals.stats;
+    const Counters& c = summaryTotals.counters;
+    fprintf(stderr, "{\"tool\": \"analyzer\", \"parser\": \"%s\", \"jobs\": %d, \"wall_seconds\": %.6f,\n", parserNames[parser], jobs, wallSeconds);
+    fprintf(stderr, " \"phases\": {");
+    for (int i = 0; i < PHASE_COUNT; ++i) {
+        fprintf(stderr, "%s\"%s\": %.6f", i > 0 ? ", " : "", phaseNames[i], t.nanos[i] / 1e9);
+    }
+    fprintf(stderr, "},\n");
+    fprintf(stderr, " \"statements\": %lld, \"tokens\": %lld, \"errors\": %lld, \"statements_per_second\": %.0f, \"tokens_per_second\": %.0f,\n",
+            t.statements, t.tokens, c.errors, wallSeconds > 0 ? t.statements / wallSeconds : 0.0, wallSeconds > 0 ? t.tokens / wallSeconds : 0.0);
+    fprintf(stderr, " \"max_nesting\": %lld, \"max_call_depth\": %lld, \"temps\": %lld, \"node_bytes\": %lld, \"arena_bytes_reserved\": %zu, \"output_bytes\": %lld}\n",
+            t.maxNesting, c.maxCallDepth, t.temps, t.nodeBytes, arenaTotals.bytesReserved, t.outputBytes);
+}
+
+/*****************************************************/
+/*
+Parallel pipeline (--jobs N)
+*/
+
+/*
+A Batch is a run of consecutive statements that one worker processes together. Its trace is kept in output until every
+earlier batch has been written, so the result is printed in the original order.
+*/
+struct Batch {
+    vector<Statement> statements;
+    int firstAssignment;
+    string output;
+    vector<Diagnostic> diagnostics;
+    bool done;
+};
+
+//Each worker owns a WorkQueue. It takes batches from the front of its own queue and, when that is empty, steals from the back of another worker's queue.
+struct WorkQueue {
+    mutex lock;
+    deque<Batch*> batches;
+};
+
+/*
+WorkStealingPool runs the workers. submit() hands batches out round-robin, a worker with nothing left steals from the others,
+and waitFor() blocks until a given batch has finished. pending counts batches that are queued but not yet taken.
+*/
+struct WorkStealingPool {
+    vector<WorkQueue> queues;
+    vector<thread> workers;
+    mutex stateLock;
+    condition_variable workReady;
+    condition_variable batchDone;
+    int pending;
+    bool stopping;
+    size_t nextQueue;
+    Options options;
+
+    WorkStealingPool(int jobs, const Options& parserOptions) : queues(jobs), pending(0), stopping(false), nextQueue(0), options(parserOptions) {
+        for (int i = 0; i < jobs; ++i) {
+            workers.push_back(thread(&WorkStealingPool::workerLoop, this, i));
+        }
+    }
+
+    void submit(Batch* batch) {
+        WorkQueue& q = queues[nextQueue++ % queues.size()];
+        {
+            lock_guard<mutex> guard(q.lock);
+            q.batches.push_back(batch);
+        }
+        lock_guard<mutex> guard(stateLock);
+        pending++;
+        workReady.notify_one();
+    }
+
+//take() pops from the worker's own queue first and otherwise steals the most recently queued batch of another worker.
+    Batch* take(size_t self) {
+        for (size_t k = 0; k < queues.size(); ++k) {
+            WorkQueue& q = queues[(self + k) % queues.size()];
+            lock_guard<mutex> guard(q.lock);
+            if (!q.batches.empty()) {
+                Batch* batch;
+                if (k == 0) {
+                    batch = q.batches.front();
+                    q.batches.pop_front();
+                } else {
+                    batch = q.batches.back();
+                    q.batches.pop_back();
+                }
+                return batch;
+            }
+        }
+        return NULL;
+    }
+
+//workerLoop() keeps its own Parser for the whole run, so parser state is never shared between threads.
+    void workerLoop(size_t self) {
+        Parser p(options);
+        for (;;) {
+            Batch* batch = take(self);
+            if (batch == NULL) {
+                unique_lock<mutex> guard(stateLock);
+                workReady.wait(guard, [this] { return pending > 0 || stopping; });
+                if (stopping) break;
+                continue;
+            }
+            {
+                lock_guard<mutex> guard(stateLock);
+                pending--;
+            }
+            runBatch(p, *batch);
+            lock_guard<mutex> guard(stateLock);
+            batch->done = true;
+            batchDone.notify_all();
+        }
+        addArenaStats(p.arena);
+        addCounters(p.counters);
+        addPhaseStats(p.stats);
+    }
+
+//runBatch() processes the batch's statements in order. A statement with an error is recorded in the batch's diagnostics and the rest go on as usual.
+    void runBatch(Parser& p, Batch& batch) {
+        for (size_t i = 0; i < batch.statements.size(); ++i) {
+            if (!processStatement(p, batch.statements[i], batch.firstAssignment + (int)i)) {
+                batch.diagnostics.push_back(p.diagnostic);
+            }
+        }
+        batch.output.swap(p.out.data);
+        p.out.clear();
+        p.numbers.clear();
+    }
+
+    void waitFor(Batch* batch) {
+        unique_lock<mutex> guard(stateLock);
+        batchDone.wait(guard, [batch] { return batch->done; });
+    }
+
+//stop() lets every worker finish its current batch and exit, dropping anything still queued.
+    void stop() {
+        for (size_t i = 0; i < queues.size(); ++i) {
+            lock_guard<mutex> guard(queues[i].lock);
+            queues[i].batches.clear();
+        }
+        {
+            lock_guard<mutex> guard(stateLock);
+            stopping = true;
+            workReady.notify_all();
+        }
+        for (size_t i = 0; i < workers.size(); ++i) {
+            workers[i].join();
+        }
+    }
+};
+
+//nextLine() is getline() counted as the read phase.
+bool nextLine(istream& in, string& line, PhaseStats& stats) {
+    PhaseTimer timer(stats, PHASE_READ);
+    return (bool)getline(in, line);
+}
+
+/*
+runParallel() reads the input in batches of about batchLines statements and keeps up to four batches per worker in flight. Batches are written
+out strictly in input order as they finish, and their diagnostics are reported in the same order. When the error limit is reached the output
+is cut right after the statement that hit it and the remaining batches are dropped.
+*/
+void runParallel(istream& fin, int jobs, int batchLines, const Options& options, ErrorLog& log, int& assignmentNumber) {
+    WorkStealingPool pool(jobs, options);
+//Reading and writing happen on this thread, so their times are kept here.
+    PhaseStats io = PhaseStats();
+    deque<Batch*> inFlight;
+    size_t maxInFlight = (size_t)jobs * 4;
+    string line;
+    int lineNumber = 0;
+    Batch* current = NULL;
+    bool more = true;
+    while (more || !inFlight.empty()) {
+//Fill the window with new batches while there is input left.
+        while (more && inFlight.size() < maxInFlight) {
+            more = nextLine(fin, line, io);
+            lineNumber++;
+            if (more && line.empty()) continue;
+            if (more) {
+                PhaseTimer timer(io, PHASE_READ);
+                if (current == NULL) {
+                    current = new Batch();
+                    current->firstAssignment = assignmentNumber;
+                    current->done = false;
+                }
+                size_t before = current->statements.size();
+                readStatements(line, lineNumber, current->statements);
+                assignmentNumber += (int)(current->statements.size() - before);
+            }
+            if (current != NULL && (!more || (int)current->statements.size() >= batchLines)) {
+                pool.submit(current);
+                inFlight.push_back(current);
+                current = NULL;
+            }
+        }
+        if (inFlight.empty()) break;
+//Write the oldest batch as soon as it is finished.
+        Batch* batch = inFlight.front();
+        inFlight.pop_front();
+        pool.waitFor(batch);
+        PhaseTimer timer(io, PHASE_WRITE);
+#ifdef COLLECT_STATS
+        io.outputBytes += (long long)batch->output.size();
+#endif
+        size_t written = 0;
+        for (size_t i = 0; i < batch->diagnostics.size() && !log.full(); ++i) {
+            const Diagnostic& d = batch->diagnostics[i];
+            fwrite(batch->output.data() + written, 1, d.outputEnd - written, stdout);
+            written = d.outputEnd;
+            fflush(stdout);
+            log.report(d);
+        }
+        if (!log.full()) fwrite(batch->output.data() + written, 1, batch->output.size() - written, stdout);
+        delete batch;
+        if (log.full()) break;
+    }
+//Stop the workers; after the error limit this also drops any batches that are still queued.
+    pool.stop();
+    for (size_t i = 0; i < inFlight.size(); ++i) {
+        delete inFlight[i];
+    }
+    delete current;
+    addPhaseStats(io);
+}
+
+/*****************************************************/
+/*
+Incremental analysis (--incremental FILE)
+
+The output of an input line depends only on the line itself, on the options and on the assignment numbers it is given (a --cse block
+also starts over at every line), so it can be kept from one run to the next. FILE holds the output and counters of every line of the last
+run that had no errors, keyed by a 64-bit FNV-1a hash of the line. The assignment numbers are cut out of the stored output (putAssignmentNumber()
+recorded where they are) and written back in when the line is reused. The file starts with a stamp of the build and of the options that
+change the output; if it does not match, the whole cache is ignored. Lines with errors are always analyzed again.
+*/
+#define CACHE_FORMAT 1
+
+struct LineResult {
+    string line;
+    string output;
+    vector<unsigned> numbers;
+    int statements;
+    Counters counters;
+    bool used;
+};
+
+struct LineCache {
+    string path;
+    string stamp;
+    map<unsigned long long, LineResult> entries;
+    long long reused;
+    long long analyzed;
+};
+
+unsigned long long hashLine(const string& line) {
+    unsigned long long h = 14695981039346656037ULL;
+    for (size_t i = 0; i < line.size(); ++i) {
+        h = (h ^ (unsigned char)line[i]) * 1099511628211ULL;
+    }
+    return h;
+}
+
+//cacheStamp() names everything a stored line depends on besides its text: the cache format, the build of this file and of the lexer, the output options, the parser and its nesting limit.
+string cacheStamp(const Options& options) {
+    char buf[192];
+    snprintf(buf, sizeof(buf), "%d %s %s lexer=%s mode=%d fold=%d cse=%d parser=%d nesting=%d", CACHE_FORMAT, __DATE__, __TIME__,
+             lexer_build(), (int)options.mode, (int)options.fold, (int)options.cse, (int)options.parser, options.maxNesting);
+    return buf;
+}
+
+/*
+These read and write the pieces of the cache file: 4-byte lengths and counts in the machine's byte order, and length-prefixed strings.
+A length is only believed if that many bytes are left in the file (size is its length), so a damaged one can't ask for gigabytes.
+*/
+bool readU32(FILE* f, unsigned& v) {
+    return fread(&v, sizeof(v), 1, f) == 1;
+}
+
+bool bytesLeft(FILE* f, long size, unsigned long long n) {
+    long at = ftell(f);
+    return at >= 0 && at <= size && n <= (unsigned long long)(size - at);
+}
+
+bool readString(FILE* f, long size, string& s) {
+    unsigned n;
+    if (!readU32(f, n) || !bytesLeft(f, size, n)) return false;
+    s.resize(n);
+    return n == 0 || fread(&s[0], 1, n, f) == n;
+}
+
+void writeU32(FILE* f, unsigned v) {
+    fwrite(&v, sizeof(v), 1, f);
+}
+
+void writeString(FILE* f, const string& s) {
+    writeU32(f, (unsigned)s.size());
+    fwrite(s.data(), 1, s.size(), f);
+}
+
+//loadCache() reads FILE if it exists and was written with the same stamp; a missing, stale or damaged file just leaves the cache empty.
+void loadCache(LineCache& cache) {
+    FILE* f = fopen(cache.path.c_str(), "rb");
+    if (f == NULL) return;
+    long size = fseek(f, 0, SEEK_END) == 0 ? ftell(f) : -1;
+    rewind(f);
+    char magic[4];
+    string stamp;
+    unsigned count = 0;
+    if (size < 0 || fread(magic, 1, 4, f) != 4 || memcmp(magic, "SYNC", 4) != 0 || !readString(f, size, stamp) || stamp != cache.stamp ||
+        !readU32(f, count)) {
+        fclose(f);
+        return;
+    }
+    for (unsigned i = 0; i < count; ++i) {
+        LineResult r;
+        unsigned n, statements;
+        if (!readString(f, size, r.line) || !readString(f, size, r.output) || !readU32(f, statements) || !readU32(f, n) ||
+            !bytesLeft(f, size, (unsigned long long)n * sizeof(unsigned))) break;
+        r.numbers.resize(n);
+        if (n > 0 && fread(&r.numbers[0], sizeof(unsigned), n, f) != n) break;
+        if (fread(&r.counters, sizeof(Counters), 1, f) != 1) break;
+        r.statements = (int)statements;
+        r.used = false;
+        cache.entries[hashLine(r.line)] = r;
+    }
+    fclose(f);
+}
+
+//saveCache() writes the lines used in this run (reused or new) to a temporary file and renames it over FILE, so lines that are gone drop out.
+void saveCache(const LineCache& cache) {
+    string temporary = cache.path + ".tmp";
+    FILE* f = fopen(temporary.c_str(), "wb");
+    if (f == NULL) {
+        fprintf(stderr, "Incremental: can't write %s\n", temporary.c_str());
+        return;
+    }
+    unsigned count = 0;
+    map<unsigned long long, LineResult>::const_iterator it;
+    for (it = cache.entries.begin(); it != cache.entries.end(); ++it) {
+        if (it->second.used) count++;
+    }
+    fwrite("SYNC", 1, 4, f);
+    writeString(f, cache.stamp);
+    writeU32(f, count);
+    for (it = cache.entries.begin(); it != cache.entries.end(); ++it) {
+        const LineResult& r = it->second;
+        if (!r.used) continue;
+        writeString(f, r.line);
+        writeString(f, r.output);
+        writeU32(f, (unsigned)r.statements);
+        writeU32(f, (unsigned)r.numbers.size());
+        if (!r.numbers.empty()) fwrite(&r.numbers[0], sizeof(unsigned), r.numbers.size(), f);
+        fwrite(&r.counters, sizeof(Counters), 1, f);
+    }
+    fclose(f);
+    rename(temporary.c_str(), cache.path.c_str());
+}
+
+//numbersPerStatement() is how many assignment numbers a statement writes: two in the trace, one in the binary stream, none in the summary.
+int numbersPerStatement(OutputMode mode) {
+    return mode == OUTPUT_FULL ? 2 : mode == OUTPUT_BINARY ? 1 : 0;
+}
+
+void addToCounters(Counters& total, const Counters& c, long long sign) {
+    total.statements += sign * c.statements;
+    total.tokens += sign * c.tokens;
+    total.postfixItems += sign * c.postfixItems;
+    total.instructions += sign * c.instructions;
+    total.errors += sign * c.errors;
+    total.folded += sign * c.folded;
+    total.simplified += sign * c.simplified;
+    total.eliminated += sign * c.eliminated;
+    total.shared += sign * c.shared;
+    total.exprHits += sign * c.exprHits;
+    total.exprMisses += sign * c.exprMisses;
+    total.exprEvictions += sign * c.exprEvictions;
+}
+
+/*
+replayLine() writes the stored output of a line into p.out with the assignment numbers from firstAssignment on, and adds its counters.
+It returns false if the line is not in the cache. A reused line isn't parsed, so the --parse-stats counters (operands, rule calls,
+call depth and parse time) are left alone: they only describe the lines that were analyzed again.
+*/
+bool replayLine(LineCache& cache, Parser& p, const string& line, int firstAssignment, int& statements) {
+    map<unsigned long long, LineResult>::iterator it = cache.entries.find(hashLine(line));
+    if (it == cache.entries.end() || it->second.line != line) return false;
+    LineResult& r = it->second;
+    int per = numbersPerStatement(p.mode);
+    size_t written = 0;
+    for (size_t k = 0; k < r.numbers.size(); ++k) {
+        p.out.write(r.output.data() + written, r.numbers[k] - written);
+        written = r.numbers[k];
+        putAssignmentNumber(p, firstAssignment + (int)k / per);
+    }
+    p.out.write(r.output.data() + written, r.output.size() - written);
+    addToCounters(p.counters, r.counters, 1);
+    r.used = true;
+    statements = r.statements;
+    cache.reused++;
+    return true;
+}
+
+/*
+storeLine() keeps the output the line just wrote into p.out, which starts at outputStart and at p.numbers[firstNumber], without its
+assignment numbers. before is p.counters from before the line.
+*/
+void storeLine(LineCache& cache, Parser& p, const string& line, size_t outputStart, size_t firstNumber, const Counters& before, int statements) {
+    LineResult r;
+    r.line = line;
+    size_t written = outputStart;
+    for (size_t k = firstNumber; k < p.numbers.size(); ++k) {
+        size_t at = p.numbers[k];
+        r.output.append(p.out.data, written, at - written);
+        r.numbers.push_back((unsigned)r.output.size());
+        written = at;
+        if (p.mode == OUTPUT_BINARY) {
+            written += sizeof(unsigned);
+        } else {
+            while (written < p.out.data.size() && isdigit((unsigned char)p.out.data[written])) written++;
+        }
+    }
+    r.output.append(p.out.data, written, string::npos);
+    r.statements = statements;
+    r.counters = p.counters;
+    addToCounters(r.counters, before, -1);
+//A reused line does not look anything up in the --expr-cache, so its lookups are not counted again.
+    r.counters.exprHits = 0;
+    r.counters.exprMisses = 0;
+    r.counters.exprEvictions = 0;
+    r.used = true;
+    cache.entries[hashLine(line)] = r;
+    cache.analyzed++;
+}
+
+/*****************************************************/
+/*
+Expression cache file (--expr-cache-file FILE)
+
+The --expr-cache entries can be kept from one run to the next. FILE starts with "SYNX" and the same stamp as --incremental, followed by
+the entries from the least to the most recently used. The symbol ids in an entry only mean something to the parser that made it, so
+every symbol operand is written as its name and interned again when the file is read. The file is read straight from a read-only
+mmap() of it; a stale or damaged file leaves the cache as it was.
+*/
+
+//MappedReader reads the pieces written by writeU32() and writeString() from the mapped file, and remembers if it ran past the end.
+struct MappedReader {
+    const char* at;
+    const char* end;
+    bool ok;
+
+    bool take(void* to, size_t n) {
+        if (!ok || (size_t)(end - at) < n) {
+            ok = false;
+            return false;
+        }
+        memcpy(to, at, n);
+        at += n;
+        return true;
+    }
+    unsigned u32() {
+        unsigned v = 0;
+        take(&v, sizeof(v));
+        return v;
+    }
+    long long i64() {
+        long long v = 0;
+        take(&v, sizeof(v));
+        return v;
+    }
+    string text() {
+        unsigned n = u32();
+        if (!ok || (size_t)(end - at) < n) {
+            ok = false;
+            return string();
+        }
+        string s(at, n);
+        at += n;
+        return s;
+    }
+};
+
+//An operand is written as a tag: 0 and the number itself for NO_OPERAND and temporaries, 1 and the name for a symbol.
+void writeOperand(FILE* f, const Parser& p, int operand) {
+    if (operand == NO_OPERAND || isTemp(operand)) {
+        fputc(0, f);
+        writeU32(f, (unsigned)operand);
+    } else {
+        fputc(1, f);
+        writeString(f, p.symbols.names[operand]);
+    }
+}
+
+int readOperand(MappedReader& in, Parser& p) {
+    unsigned char tag = 0;
+    in.take(&tag, 1);
+    if (tag == 0) return (int)in.u32();
+    string name = in.text();
+    return p.symbols.intern(name.data(), name.size());
+}
+
+void saveExprCache(const Parser& p, const string& path, const string& stamp) {
+    string temporary = path + ".tmp";
+    FILE* f = fopen(temporary.c_str(), "wb");
+    if (f == NULL) {
+        fprintf(stderr, "Expression cache: can't write %s\n", temporary.c_str());
+        return;
+    }
+    fwrite("SYNX", 1, 4, f);
+    writeString(f, stamp);
+    writeU32(f, (unsigned)p.exprCache.entries.size());
+    list<ExprEntry>::const_reverse_iterator it;
+    for (it = p.exprCache.entries.rbegin(); it != p.exprCache.entries.rend(); ++it) {
+        const ExprEntry& e = *it;
+        writeString(f, e.key);
+        writeString(f, e.trace);
+        long long counts[4] = {e.folded, e.simplified, e.eliminated, e.shared};
+        fwrite(counts, sizeof(counts), 1, f);
+        writeU32(f, (unsigned)e.postfix.size());
+        for (size_t i = 0; i < e.postfix.size(); ++i) {
+            fputc((unsigned char)e.postfix[i].op, f);
+            writeOperand(f, p, e.postfix[i].operand);
+        }
+        writeU32(f, (unsigned)e.ir.size());
+        for (size_t i = 0; i < e.ir.size(); ++i) {
+            fputc((unsigned char)e.ir[i].op, f);
+            writeOperand(f, p, e.ir[i].arg1);
+            writeOperand(f, p, e.ir[i].arg2);
+            writeOperand(f, p, e.ir[i].result);
+        }
+    }
+    fclose(f);
+    rename(temporary.c_str(), path.c_str());
+}
+
+void loadExprCache(Parser& p, const string& path, const string& stamp) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < 4) {
+        close(fd);
+        return;
+    }
+    void* data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return;
+    MappedReader in = {(const char*)data, (const char*)data + st.st_size, true};
+    char magic[4];
+    in.take(magic, 4);
+    if (memcmp(magic, "SYNX", 4) == 0 && in.text() == stamp && in.ok) {
+        unsigned count = in.u32();
+        long long evictions = p.counters.exprEvictions;
+        for (unsigned k = 0; k < count && in.ok; ++k) {
+            ExprEntry e;
+            e.key = in.text();
+            e.trace = in.text();
+            e.folded = in.i64();
+            e.simplified = in.i64();
+            e.eliminated = in.i64();
+            e.shared = in.i64();
+            unsigned n = in.u32();
+            for (unsigned i = 0; i < n && in.ok; ++i) {
+                PostfixItem item;
+                unsigned char op = 0;
+                in.take(&op, 1);
+                item.op = (TokenType)op;
+                item.operand = readOperand(in, p);
+                e.postfix.push_back(item);
+            }
+            n = in.u32();
+            for (unsigned i = 0; i < n && in.ok; ++i) {
+                Quad q;
+                unsigned char op = 0;
+                in.take(&op, 1);
+                q.op = (TokenType)op;
+                q.arg1 = readOperand(in, p);
+                q.arg2 = readOperand(in, p);
+                q.result = readOperand(in, p);
+                e.ir.push_back(q);
+            }
+            if (in.ok && !e.key.empty()) addExpr(p, e);
+        }
+//Entries dropped because the file holds more than the budget are not evictions of this run.
+        p.counters.exprEvictions = evictions;
+    }
+    munmap(data, (size_t)st.st_size);
+}
+
+//This code starts the main function, reads the options (an input path, which defaults to front.in, --jobs N, --batch LINES, --arena-stats, --arena-block BYTES, --output full|summary|binary, --max-errors N, --fold, --cse statement|block, --eval N, --columnar, --emit-cpp DIR, --incremental FILE, --expr-cache BYTES, --expr-cache-file FILE, --stream, --max-statement BYTES, --parser recursive|pratt|stack, --max-nesting N, --parse-stats and --stats), opens the input file, and checks if it's accessible and if not, it prints an error and exits the program.
+int main(int argc, char* argv[]) {
+    chrono::steady_clock::time_point runStart = chrono::steady_clock::now();
+    const char* path = "front.in";
+    bool arenaStats = false;
+    bool stats = false;
+    Options options = {64 * 1024, OUTPUT_FULL, false, CSE_OFF, 0, PARSER_RECURSIVE, false, MAX_NESTING};
+    string exprCacheFile;
+    int jobs = 1;
+    int batchLines = 256;
+    int maxErrors = 100;
+    long long evalRuns = 0;
+    bool columnar = false;
+    NativeCode native;
+    native.reused = 0;
+    native.writeFailed = false;
+    LineCache cache;
+    cache.reused = 0;
+    cache.analyzed = 0;
+    bool stream = false;
+    size_t maxStatement = 0;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--output" && i + 1 < argc && string(argv[i + 1]) == "full") {
+            options.mode = OUTPUT_FULL;
+            i++;
+        } else if (arg == "--output" && i + 1 < argc && string(argv[i + 1]) == "summary") {
+            options.mode = OUTPUT_SUMMARY;
+            i++;
+        } else if (arg == "--output" && i + 1 < argc && string(argv[i + 1]) == "binary") {
+            options.mode = OUTPUT_BINARY;
+            i++;
+        } else if (arg == "--arena-stats") {
+            arenaStats = true;
+        } else if (arg == "--arena-block" && i + 1 < argc) {
+            options.arenaBlock = strtoul(argv[++i], NULL, 10);
+        } else if (arg == "--eval" && i + 1 < argc) {
+            evalRuns = atoll(argv[++i]);
+        } else if (arg == "--emit-cpp" && i + 1 < argc) {
+            native.dir = argv[++i];
+        } else if (arg == "--expr-cache" && i + 1 < argc) {
+            options.exprCacheBytes = strtoul(argv[++i], NULL, 10);
+        } else if (arg == "--expr-cache-file" && i + 1 < argc) {
+            exprCacheFile = argv[++i];
+        } else if (arg == "--stream") {
+            stream = true;
+        } else if (arg == "--max-statement" && i + 1 < argc) {
+            maxStatement = strtoul(argv[++i], NULL, 10);
+        } else if (arg == "--incremental" && i + 1 < argc) {
+            cache.path = argv[++i];
+        } else if (arg == "--columnar") {
+            columnar = true;
+        } else if (arg == "--fold") {
+            options.fold = true;
+        } else if (arg == "--parser" && i + 1 < argc && string(argv[i + 1]) == "recursive") {
+            options.parser = PARSER_RECURSIVE;
+            i++;
+        } else if (arg == "--parser" && i + 1 < argc && string(argv[i + 1]) == "pratt") {
+            options.parser = PARSER_PRATT;
+            i++;
+        } else if (arg == "--parser" && i + 1 < argc && string(argv[i + 1]) == "stack") {
+            options.parser = PARSER_STACK;
+            i++;
+        } else if (arg == "--max-nesting" && i + 1 < argc) {
+            options.maxNesting = atoi(argv[++i]);
+        } else if (arg == "--parse-stats") {
+            options.parseStats = true;
+        } else if (arg == "--stats") {
+            stats = true;
+        } else if (arg == "--cse" && i + 1 < argc && string(argv[i + 1]) == "statement") {
+            options.cse = CSE_STATEMENT;
+            i++;
+        } else if (arg == "--cse" && i + 1 < argc && string(argv[i + 1]) == "block") {
+            options.cse = CSE_BLOCK;
+            i++;
+        } else if (arg == "--max-errors" && i + 1 < argc) {
+            maxErrors = atoi(argv[++i]);
+        } else if (arg == "--jobs" && i + 1 < argc) {
+            jobs = atoi(argv[++i]);
+        } else if (arg == "--batch" && i + 1 < argc) {
+            batchLines = atoi(argv[++i]);
+        } else if (arg[0] == '-') {
+            cerr << "Usage: " << argv[0] << " [--jobs N] [--batch LINES] [--arena-stats] [--arena-block BYTES] [--output full|summary|binary] [--max-errors N] [--fold] [--cse statement|block] [--eval N] [--columnar] [--emit-cpp DIR] [--incremental FILE] [--expr-cache BYTES] [--expr-cache-file FILE] [--stream] [--max-statement BYTES] [--parser recursive|pratt|stack] [--max-nesting N] [--parse-stats] [--stats] [input file]" << endl;
+            return 1;
+        } else {
+            path = argv[i];
+        }
+    }
+//--eval compiles every statement into one program, so the statements are analyzed on a single thread; --incremental and --expr-cache-file keep one cache, so they do too.
+    if (jobs < 1 || evalRuns > 0 || !native.dir.empty() || !cache.path.empty() || !exprCacheFile.empty() || stream) jobs = 1;
+    if (!exprCacheFile.empty() && options.exprCacheBytes == 0) options.exprCacheBytes = DEFAULT_EXPR_CACHE;
+//A function is made for one statement on its own, so it can't use temporaries from the statements before it.
+    if (!native.dir.empty() && options.cse == CSE_BLOCK) {
+        cerr << "--emit-cpp can't be used with --cse block" << endl;
+        return 1;
+    }
+//--incremental keeps whole lines, which --stream never holds.
+    if (stream && !cache.path.empty()) {
+        cerr << "--stream can't be used with --incremental" << endl;
+        return 1;
+    }
+#ifndef COLLECT_STATS
+    if (stats) {
+        cerr << "--stats needs a build with -DCOLLECT_STATS" << endl;
+        return 1;
+    }
+#endif
+//The recursive parsers use the thread's stack for every level, so only the explicit-stack parser can be allowed deeper (or without a limit).
+    if (options.parser != PARSER_STACK && (options.maxNesting <= 0 || options.maxNesting > MAX_NESTING)) {
+        cerr << "--max-nesting above " << MAX_NESTING << " (or 0) needs --parser stack" << endl;
+        return 1;
+    }
+    if (options.maxNesting < 0) options.maxNesting = 0;
+//A reused line is never parsed, so there is no intermediate code to compile for --eval or --emit-cpp.
+    if (!cache.path.empty() && (evalRuns > 0 || !native.dir.empty())) {
+        cerr << "--incremental can't be used with --eval or --emit-cpp" << endl;
+        return 1;
+    }
+    if (batchLines < 1) batchLines = 1;
+    arenaTotals.blockSize = options.arenaBlock;
+    ifstream fin(path);
+    if (!fin.is_open()) {
+        cerr << "Error: Could not open " << path << endl;
+        return 1;
+    }
+    if (!native.dir.empty()) loadIndex(native);
+    if (!cache.path.empty()) {
+        cache.stamp = cacheStamp(options);
+        loadCache(cache);
+    }
+//With --jobs above 1 the lines are spread over a pool of worker threads; otherwise they are processed one at a time right here.
+    ErrorLog log = {path, maxErrors, 0};
+    Program program;
+    int assignmentNumber = 1;
+    if (options.mode == OUTPUT_BINARY) writeBinaryHeader();
+    if (jobs > 1) {
+        runParallel(fin, jobs, batchLines, options, log, assignmentNumber);
+    } else {
+//These lines initialize a string to hold each input line and one parser, then loop through each line in the file, skipping any empty lines, and write the collected output whenever enough of it has built up. An error is reported and the run goes on with the next statement, until the error limit is reached.
+        Parser p(options);
+        if (!exprCacheFile.empty()) loadExprCache(p, exprCacheFile, cacheStamp(options));
+//runStatement() analyzes one statement, reports its error if it has one, and adds it to the --eval program and the --emit-cpp functions.
+        auto runStatement = [&](const Statement& stmt) -> bool {
+            if (!processStatement(p, stmt, assignmentNumber++)) {
+                writeOutput(p);
+                fflush(stdout);
+                log.report(p.diagnostic);
+                return false;
+            }
+            if (evalRuns > 0) compileStatement(program, p);
+            if (!native.dir.empty()) addNativeStatement(native, program, p);
+            return true;
+        };
+        string line;
+        vector<Statement> statements;
+        int lineNumber = 0;
+/*
+With --stream the statements come from a StatementReader instead of whole lines. Unless a later step still needs them, the symbols are
+forgotten once there are STREAM_SYMBOLS of them, before any statement, so they can't grow with a line or the file either. A --cse block
+shares names and trees between its statements, so it is ended there too (and after STREAM_SYMBOLS statements): the next statement
+starts a new block, as if it began a line.
+*/
+        if (stream) {
+            FILE* in = fopen(path, "rb");
+            if (in == NULL) {
+                cerr << "Error: Could not open " << path << endl;
+                return 1;
+            }
+            StatementReader reader(in, maxStatement);
+            bool keepSymbols = evalRuns > 0 || !native.dir.empty() || options.exprCacheBytes > 0;
+            int blockStatements = 0;
+            Statement stmt;
+            while (!log.full() && nextStatement(reader, stmt, p.stats)) {
+                if (reader.tooLong) {
+                    p.counters.errors++;
+                    assignmentNumber++;
+                    Diagnostic d = {stmt.line, stmt.column + 1, "statement is longer than " + to_string(maxStatement) + " bytes", 0};
+                    writeOutput(p);
+                    fflush(stdout);
+                    log.report(d);
+                    continue;
+                }
+                if (!keepSymbols && p.symbols.names.size() > STREAM_SYMBOLS) {
+                    p.symbols.clear();
+                    stmt.startsLine = true;
+                }
+                if (p.cse == CSE_BLOCK && ++blockStatements > STREAM_SYMBOLS) stmt.startsLine = true;
+                if (stmt.startsLine) blockStatements = 1;
+                runStatement(stmt);
+                if (p.out.data.size() >= OUTPUT_FLUSH_SIZE) writeOutput(p);
+            }
+            fclose(in);
+        }
+        while (!stream && !log.full() && nextLine(fin, line, p.stats)) {
+            lineNumber++;
+            if (line.empty()) continue;
+//With --incremental a line that is in the cache is written from there; otherwise it is analyzed and, if it had no errors, stored.
+            int reusedStatements = 0;
+            if (!cache.path.empty() && replayLine(cache, p, line, assignmentNumber, reusedStatements)) {
+                assignmentNumber += reusedStatements;
+                if (p.out.data.size() >= OUTPUT_FLUSH_SIZE) writeOutput(p);
+                continue;
+            }
+            size_t outputStart = p.out.data.size();
+            size_t firstNumber = p.numbers.size();
+            Counters before = p.counters;
+            bool clean = true;
+//readStatements() may take the text out of line, so the cache keeps its own copy.
+            string cached;
+            if (!cache.path.empty()) cached = line;
+            statements.clear();
+            {
+                PhaseTimer timer(p.stats, PHASE_READ);
+                readStatements(line, lineNumber, statements);
+            }
+            for (size_t i = 0; i < statements.size() && !log.full(); ++i) {
+                if (!runStatement(statements[i])) clean = false;
+            }
+            if (!cache.path.empty() && clean) storeLine(cache, p, cached, outputStart, firstNumber, before, (int)statements.size());
+            if (p.out.data.size() >= OUTPUT_FLUSH_SIZE) writeOutput(p);
+        }
+        writeOutput(p);
+        addArenaStats(p.arena);
+        addCounters(p.counters);
+        addPhaseStats(p.stats);
+        if (!exprCacheFile.empty()) saveExprCache(p, exprCacheFile, cacheStamp(options));
+    }
+
+    fin.close();
+//The totals are only printed when the whole input was analyzed, not when the run stopped at the error limit.
+    if (options.mode == OUTPUT_SUMMARY && !log.full()) {
+        printSummary();
+    }
+    if (options.fold && !log.full()) {
+        printFoldStats();
+    }
+    if (options.cse != CSE_OFF && !log.full()) {
+        printCseStats();
+    }
+    if (options.exprCacheBytes > 0 && !log.full()) {
+        printExprCacheStats();
+    }
+    if (options.parseStats && !log.full()) {
+        printParseStats(options.parser);
+    }
+    if (!cache.path.empty() && !log.full()) {
+        saveCache(cache);
+        fprintf(stderr, "Incremental: %lld lines reused, %lld analyzed, %s\n", cache.reused, cache.analyzed, cache.path.c_str());
+    }
+    bool nativeReady = false;
+    if (!native.dir.empty() && !log.full()) {
+        nativeReady = buildNative(native);
+        if (!nativeReady) return 1;
+    }
+    if (evalRuns > 0 && !log.full()) {
+        finishProgram(program);
+        benchmarkEval(program, evalRuns, columnar, nativeReady ? &native : NULL);
+    }
+    if (arenaStats && !log.full()) {
+        printArenaStats(assignmentNumber - 1);
+    }
+//--stats is written even when the run stopped at the error limit, since that is often the run worth looking at.
+    if (stats) {
+        printStatsJson(chrono::duration<double>(chrono::steady_clock::now() - runStart).count(), jobs, options.parser);
+    }
+    return log.count > 0 ? 1 : 0;
+}
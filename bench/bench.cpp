@@ -0,0 +1,615 @@
+// Yutong Ye 12012842
+
+/*
+bench.cpp is the benchmark harness for the lexical analyzer and the syntax analyzer. It does two things:
+
+    bench gen SHAPE BYTES [SEED]        writes a synthetic front.in of about BYTES bytes and the given shape to stdout
+    bench run LEXER ANALYZER [options]  generates one corpus per shape, runs the programs on it and reports throughput and peak memory
+    bench stress ANALYZER [options]     checks that the analyzer survives input nested 1,000,000 levels deep and stops cleanly at its limit
+
+The corpora are made by a small random number generator of our own, so the same shape, size and seed give the same file on every machine.
+The shared lexer counts the tokens of every corpus, so tokens per second can be reported for any build of the programs. Build it with
+
+    g++ -O2 bench/bench.cpp Lexer.cpp -o bench/bench
+*/
+
+//These headers handle printing, strings and the lists of results.
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <map>
+//This header times every run.
+#include <chrono>
+//These POSIX headers start the programs and read back their peak memory with wait4().
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+//This header is the shared lexer, used to count the tokens of a corpus.
+#include "../Lexer.h"
+
+using namespace std;
+
+/*****************************************************/
+/*
+Corpus generator
+*/
+
+//Rng is xorshift64*, so a seed always gives the same numbers whatever the C library's rand() does.
+struct Rng {
+    unsigned long long state;
+
+    Rng(unsigned long long seed) : state(seed * 2685821657736338717ULL + 1) {}
+
+    unsigned long long next() {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 2685821657736338717ULL;
+    }
+
+//below() gives a number from 0 to n - 1.
+    int below(int n) {
+        return (int)(next() % (unsigned long long)n);
+    }
+};
+
+//Names only use letters and digits, so both lexers read them as one identifier.
+static const char* const nameList[] = {
+    "a", "b", "c", "x", "y", "z", "sum", "total", "count", "index", "value", "result", "left", "right", "temp", "alpha"
+};
+
+static const char* const binaryOps[] = {"+", "-", "*", "/"};
+static const char* const compareOps[] = {"<", "<=", ">", ">=", "==", "!="};
+static const char* const keywordList[] = {
+    "int", "short", "long", "signed", "unsigned", "float", "double", "const", "do", "else", "for", "if", "switch", "while"
+};
+
+#define COUNT(list) (int)(sizeof(list) / sizeof(list[0]))
+
+//name() adds a variable name, sometimes with a number after it so there are many distinct names.
+void name(Rng& rng, string& out) {
+    out += nameList[rng.below(COUNT(nameList))];
+    if (rng.below(2) == 0) out += to_string(rng.below(100));
+}
+
+//operand() adds a name or an integer constant.
+void operand(Rng& rng, string& out) {
+    if (rng.below(4) == 0) out += to_string(rng.below(1000));
+    else name(rng, out);
+}
+
+//flatLine() is one long assignment with no parentheses: x = a + b * c - d / e ... with 50 to 150 operands.
+void flatLine(Rng& rng, string& out) {
+    name(rng, out);
+    out += " = ";
+    int operands = 50 + rng.below(101);
+    for (int i = 0; i < operands; i++) {
+        if (i > 0) {
+            out += ' ';
+            out += binaryOps[rng.below(COUNT(binaryOps))];
+            out += ' ';
+        }
+        operand(rng, out);
+    }
+}
+
+//deepLine() nests 50 to 500 levels of parentheses, ((((a + b) * c) - d) ...), or a chain of unary minus in front of a parenthesis.
+void deepLine(Rng& rng, string& out) {
+    name(rng, out);
+    out += " = ";
+    int depth = 50 + rng.below(451);
+    if (rng.below(4) == 0) {
+        out.append(depth, '-');
+        out += '(';
+        operand(rng, out);
+        out += " + ";
+        operand(rng, out);
+        out += ')';
+        return;
+    }
+    out.append(depth, '(');
+    operand(rng, out);
+    for (int i = 0; i < depth; i++) {
+        out += ' ';
+        out += binaryOps[rng.below(COUNT(binaryOps))];
+        out += ' ';
+        operand(rng, out);
+        out += ')';
+    }
+}
+
+//keywordLine() is a line of C control flow and declarations, mostly keywords, braces and semicolons.
+void keywordLine(Rng& rng, string& out) {
+    int statements = 4 + rng.below(8);
+    for (int i = 0; i < statements; i++) {
+        if (i > 0) out += ' ';
+        const char* keyword = keywordList[rng.below(COUNT(keywordList))];
+        if (strcmp(keyword, "if") == 0 || strcmp(keyword, "while") == 0 || strcmp(keyword, "switch") == 0) {
+            out += keyword;
+            out += " (";
+            name(rng, out);
+            out += ' ';
+            out += compareOps[rng.below(COUNT(compareOps))];
+            out += ' ';
+            operand(rng, out);
+            out += ") {";
+        } else if (strcmp(keyword, "for") == 0) {
+            out += "for (i = 0; i < ";
+            operand(rng, out);
+            out += "; i++) {";
+        } else if (strcmp(keyword, "do") == 0 || strcmp(keyword, "else") == 0) {
+            out += "} ";
+            out += keyword;
+            out += " {";
+        } else {
+            out += keyword;
+            out += ' ';
+            name(rng, out);
+            out += " = ";
+            operand(rng, out);
+            out += ';';
+        }
+    }
+    out += " }";
+}
+
+//floatLine() is an assignment whose constants are floating point numbers like 3.25.
+void floatLine(Rng& rng, string& out) {
+    name(rng, out);
+    out += " = ";
+    int operands = 5 + rng.below(20);
+    for (int i = 0; i < operands; i++) {
+        if (i > 0) {
+            out += ' ';
+            out += binaryOps[rng.below(COUNT(binaryOps))];
+            out += ' ';
+        }
+        if (rng.below(4) == 0) {
+            name(rng, out);
+        } else {
+            out += to_string(rng.below(1000));
+            out += '.';
+            out += to_string(rng.below(100000));
+        }
+    }
+    out += ';';
+}
+
+//arrayLine() assigns between array elements like a[3] = b[12] + c[7].
+void arrayLine(Rng& rng, string& out) {
+    name(rng, out);
+    out += '[' + to_string(rng.below(64)) + "] = ";
+    int operands = 3 + rng.below(15);
+    for (int i = 0; i < operands; i++) {
+        if (i > 0) {
+            out += ' ';
+            out += binaryOps[rng.below(COUNT(binaryOps))];
+            out += ' ';
+        }
+        name(rng, out);
+        if (rng.below(5) != 0) out += '[' + to_string(rng.below(1024)) + ']';
+    }
+    out += ';';
+}
+
+//errorLine() starts from a valid assignment and, five times out of six, breaks it: a stray character, a missing operand, an unclosed parenthesis or a missing variable.
+void errorLine(Rng& rng, string& out) {
+    string line;
+    name(rng, line);
+    line += " = (";
+    int operands = 3 + rng.below(20);
+    for (int i = 0; i < operands; i++) {
+        if (i > 0) {
+            line += ' ';
+            line += binaryOps[rng.below(COUNT(binaryOps))];
+            line += ' ';
+        }
+        operand(rng, line);
+    }
+    line += ')';
+    switch (rng.below(6)) {
+        case 0: line.insert(line.size() / 2, "#"); break;
+        case 1: line.insert(line.size() / 2, " @ $"); break;
+        case 2: line += " +"; break;
+        case 3: line.erase(line.size() - 1); break;
+        case 4: line = "= " + line; break;
+        default: break;
+    }
+    out += line;
+}
+
+typedef void (*LineMaker)(Rng&, string&);
+
+/*
+A Shape is one kind of corpus. The keyword, float and array lines are C the syntax analyzer doesn't accept (every one of them is an
+error), so they only measure the lexer; analyzer is false for them. The error shape measures both, since reporting errors is its point.
+*/
+struct Shape {
+    const char* name;
+    LineMaker line;
+    bool analyzer;
+};
+
+static const Shape shapes[] = {
+    {"flat", flatLine, true}, {"deep", deepLine, true}, {"keyword", keywordLine, false}, {"float", floatLine, false},
+    {"array", arrayLine, false}, {"error", errorLine, true}
+};
+
+//generate() makes a corpus of one shape: lines are added until it holds at least bytes bytes.
+string generate(const Shape& shape, size_t bytes, unsigned long long seed) {
+    Rng rng(seed);
+    string out;
+    out.reserve(bytes + 4096);
+    while (out.size() < bytes) {
+        shape.line(rng, out);
+        out += '\n';
+    }
+    return out;
+}
+
+const Shape* findShape(const char* name) {
+    for (int i = 0; i < COUNT(shapes); i++) {
+        if (strcmp(shapes[i].name, name) == 0) return &shapes[i];
+    }
+    return NULL;
+}
+
+/*****************************************************/
+/*
+Harness
+*/
+
+//A RunResult is the best wall time of the runs of one program on one corpus and the largest peak memory any of them needed.
+struct RunResult {
+    double seconds;
+    long peakKb;
+    bool crashed;
+};
+
+/*
+runOnce() starts a program with its output (stdout and stderr) written to outputPath, or thrown away when that is NULL, waits for it
+with wait4() to get its peak resident memory (ru_maxrss, in kilobytes on Linux), and times it. A program killed by a signal, or one
+that couldn't be started (exit code 126 or 127 from the child), counts as crashed; any other exit code is handed back in exitCode, since
+the analyzer returns 1 whenever it found errors.
+*/
+bool runOnce(const vector<string>& args, const char* outputPath, double& seconds, long& peakKb, int& exitCode) {
+    vector<char*> argv;
+    for (size_t i = 0; i < args.size(); i++) argv.push_back((char*)args[i].c_str());
+    argv.push_back(NULL);
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    pid_t pid = fork();
+    if (pid < 0) return false;
+    if (pid == 0) {
+        int out = outputPath != NULL ? open(outputPath, O_WRONLY | O_CREAT | O_TRUNC, 0644) : open("/dev/null", O_WRONLY);
+        if (out < 0) _exit(126);
+        dup2(out, 1);
+        dup2(out, 2);
+        execv(argv[0], &argv[0]);
+        _exit(127);
+    }
+    int status = 0;
+    struct rusage usage;
+    if (wait4(pid, &status, 0, &usage) < 0) return false;
+    seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    peakKb = usage.ru_maxrss;
+    exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+    return !WIFSIGNALED(status) && !(WIFEXITED(status) && (WEXITSTATUS(status) == 126 || WEXITSTATUS(status) == 127));
+}
+
+RunResult measure(const vector<string>& args, int runs) {
+    RunResult r = {0, 0, false};
+    for (int i = 0; i < runs; i++) {
+        double seconds = 0;
+        long peakKb = 0;
+        int exitCode = 0;
+        if (!runOnce(args, NULL, seconds, peakKb, exitCode)) {
+            r.crashed = true;
+            return r;
+        }
+        if (i == 0 || seconds < r.seconds) r.seconds = seconds;
+        if (peakKb > r.peakKb) r.peakKb = peakKb;
+    }
+    return r;
+}
+
+//The baseline file has one line per program and corpus: tool, shape, MB/s and peak KB, separated by tabs.
+map<string, pair<double, long> > loadBaseline(const char* path) {
+    map<string, pair<double, long> > baseline;
+    FILE* f = fopen(path, "r");
+    if (f == NULL) {
+        fprintf(stderr, "Can't read baseline %s\n", path);
+        exit(2);
+    }
+    char tool[64], shape[64];
+    double mbps;
+    long kb;
+    while (fscanf(f, "%63s %63s %lf %ld", tool, shape, &mbps, &kb) == 4) {
+        baseline[string(tool) + " " + shape] = make_pair(mbps, kb);
+    }
+    fclose(f);
+    return baseline;
+}
+
+//countTokens() is how many tokens the shared lexer finds in a corpus in one dialect, the end of the input not included.
+long long countTokens(const string& corpus, int dialect) {
+    Lexer lx;
+    LexToken tok;
+    lexer_init(&lx, corpus.data(), corpus.size(), dialect);
+    long long tokens = 0;
+    while (lexer_next(&lx, &tok) != END_OF_FILE) tokens++;
+    return tokens;
+}
+
+void usage() {
+    fprintf(stderr, "Usage: bench gen flat|deep|keyword|float|array|error BYTES [SEED]\n"
+                    "       bench run LEXER|- ANALYZER|- [--bytes N] [--runs N] [--seed N] [--dir DIR] [--trace] [--save FILE] [--baseline FILE] [--tolerance PCT]\n"
+                    "       bench stress ANALYZER [--depth N] [--dir DIR]\n");
+}
+
+/*
+runBench() writes every corpus to DIR, runs the lexer on each and the analyzer on the shapes it accepts (both with --output summary,
+the analyzer with --max-errors 0 so error-heavy input is read to the end), and prints a table with MB/s and millions of tokens per
+second (the tokens the shared lexer finds in the corpus, in the program's dialect). A program given as - is skipped. --trace runs the
+programs with nothing but the input file, so they print their default full trace (to /dev/null); that also works with builds from
+before --output existed, for comparing the speed of old and new versions. --save keeps the numbers as a baseline; --baseline compares
+against one and reports every program that got slower or bigger than the tolerance allows, and then exits with 1, so a script can
+catch it.
+*/
+int runBench(int argc, char* argv[]) {
+    if (argc < 4) {
+        usage();
+        return 2;
+    }
+    string lexer = argv[2], analyzer = argv[3];
+    size_t bytes = 8 << 20;
+    int runs = 3;
+    unsigned long long seed = 1;
+    string dir = ".";
+    const char* savePath = NULL;
+    const char* baselinePath = NULL;
+    double tolerance = 10;
+    bool trace = false;
+    for (int i = 4; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--bytes" && i + 1 < argc) bytes = strtoull(argv[++i], NULL, 10);
+        else if (arg == "--runs" && i + 1 < argc) runs = atoi(argv[++i]);
+        else if (arg == "--seed" && i + 1 < argc) seed = strtoull(argv[++i], NULL, 10);
+        else if (arg == "--dir" && i + 1 < argc) dir = argv[++i];
+        else if (arg == "--save" && i + 1 < argc) savePath = argv[++i];
+        else if (arg == "--baseline" && i + 1 < argc) baselinePath = argv[++i];
+        else if (arg == "--tolerance" && i + 1 < argc) tolerance = atof(argv[++i]);
+        else if (arg == "--trace") trace = true;
+        else {
+            usage();
+            return 2;
+        }
+    }
+    if (runs < 1) runs = 1;
+    map<string, pair<double, long> > baseline;
+    if (baselinePath != NULL) baseline = loadBaseline(baselinePath);
+    FILE* save = savePath != NULL ? fopen(savePath, "w") : NULL;
+    int regressions = 0;
+
+    printf("%-9s %-8s %10s %9s %9s %9s %10s\n", "tool", "shape", "bytes", "best s", "MB/s", "Mtok/s", "peak MB");
+    for (int s = 0; s < COUNT(shapes); s++) {
+        string corpus = generate(shapes[s], bytes, seed);
+        string path = dir + "/bench-" + shapes[s].name + ".in";
+        FILE* f = fopen(path.c_str(), "wb");
+        if (f == NULL || fwrite(corpus.data(), 1, corpus.size(), f) != corpus.size()) {
+            fprintf(stderr, "Can't write %s\n", path.c_str());
+            return 2;
+        }
+        fclose(f);
+        for (int tool = 0; tool < (shapes[s].analyzer ? 2 : 1); tool++) {
+            vector<string> args;
+            args.push_back(tool == 0 ? lexer : analyzer);
+            if (args[0] == "-") continue;
+            if (!trace) {
+                args.push_back("--output");
+                args.push_back("summary");
+            }
+            if (tool == 1 && !trace) {
+                args.push_back("--max-errors");
+                args.push_back("0");
+            }
+            args.push_back(path);
+            long long tokens = countTokens(corpus, tool == 0 ? LEX_C : LEX_EXPR);
+            const char* toolName = tool == 0 ? "lexer" : "analyzer";
+            RunResult r = measure(args, runs);
+            if (r.crashed) {
+                printf("%-9s %-8s %10zu   crashed\n", toolName, shapes[s].name, corpus.size());
+                regressions++;
+                continue;
+            }
+            double mbps = r.seconds > 0 ? corpus.size() / r.seconds / 1e6 : 0;
+            double mtoks = r.seconds > 0 ? tokens / r.seconds / 1e6 : 0;
+            printf("%-9s %-8s %10zu %9.3f %9.1f %9.2f %10.1f", toolName, shapes[s].name, corpus.size(), r.seconds, mbps, mtoks,
+                   r.peakKb / 1024.0);
+            if (save != NULL) fprintf(save, "%s\t%s\t%.3f\t%ld\n", toolName, shapes[s].name, mbps, r.peakKb);
+    //A program is a regression when its throughput dropped, or its peak memory grew, by more than the tolerance.
+            map<string, pair<double, long> >::iterator it = baseline.find(string(toolName) + " " + shapes[s].name);
+            if (it != baseline.end()) {
+                double speed = it->second.first > 0 ? 100.0 * (mbps / it->second.first - 1) : 0;
+                double memory = it->second.second > 0 ? 100.0 * ((double)r.peakKb / it->second.second - 1) : 0;
+                printf("   %+6.1f%% speed %+6.1f%% memory", speed, memory);
+                if (speed < -tolerance || memory > tolerance) {
+                    printf("   REGRESSION");
+                    regressions++;
+                }
+            }
+            printf("\n");
+            fflush(stdout);
+        }
+    }
+    if (save != NULL) fclose(save);
+    return regressions > 0 ? 1 : 0;
+}
+
+/*****************************************************/
+/*
+Stress test
+*/
+
+/*
+nestedStatement() writes "x = " and a factor nested depth levels deep in one of four ways: parentheses (((a))), unary minus ---a,
+logical not !!!a, or, for '+', a sum a + a + ... of depth operands, which nests the tree (not the factor) depth levels deep.
+*/
+string nestedStatement(char kind, int depth) {
+    string s = "x = ";
+    if (kind == '+') {
+        s.reserve(4 + 4 * (size_t)depth);
+        for (int i = 0; i < depth; i++) s += i == 0 ? "a" : " + a";
+    } else if (kind == '(') {
+        s.append(depth, '(');
+        s += 'a';
+        s.append(depth, ')');
+    } else {
+        s.append(depth, kind);
+        s += 'a';
+    }
+    return s + "\n";
+}
+
+//StressCheck is one run of the stress test: the input, the analyzer options, and the exit code and summary lines it must produce.
+struct StressCheck {
+    string name;
+    string input;
+    vector<string> options;
+    int exitCode;
+    string expect;
+};
+
+//readFile() returns a whole file as a string (empty if it can't be read).
+string readFile(const string& path) {
+    string text;
+    FILE* f = fopen(path.c_str(), "rb");
+    if (f == NULL) return text;
+    char buf[65536];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) text.append(buf, n);
+    fclose(f);
+    return text;
+}
+
+/*
+runStress() checks the analyzer on pathologically deep input. At --depth (1,000,000 by default) the explicit-stack parser must analyze
+parentheses, unary minus, logical not and a long sum without a limit (--max-nesting 0), also with --fold and --cse, where the tree
+passes walk the deep trees. At the default limit every parser must accept a factor nested 4096 levels deep and report the same
+factor nested 4097 levels deep as an error, instead of overflowing its stack. One more check guards the expression language itself:
+names spelled like C keywords are ordinary variables there, so "int = do + long" must give the same postfix as the first version of the
+analyzer. Each check prints ok or FAILED with its time and peak memory; the exit status is 1 if any failed.
+*/
+int runStress(int argc, char* argv[]) {
+    if (argc < 3) {
+        usage();
+        return 2;
+    }
+    string analyzer = argv[2];
+    int depth = 1000000;
+    string dir = ".";
+    for (int i = 3; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--depth" && i + 1 < argc) depth = atoi(argv[++i]);
+        else if (arg == "--dir" && i + 1 < argc) dir = argv[++i];
+        else {
+            usage();
+            return 2;
+        }
+    }
+    string deep, limit;
+    const char kinds[] = {'(', '-', '!', '+'};
+    for (int k = 0; k < 4; k++) deep += nestedStatement(kinds[k], depth);
+    for (int k = 0; k < 3; k++) limit += nestedStatement(kinds[k], 4096) + nestedStatement(kinds[k], 4097);
+    string names = "int = do + long\n";
+    string deepPath = dir + "/stress-deep.in", limitPath = dir + "/stress-limit.in", namesPath = dir + "/stress-names.in";
+    string outputPath = dir + "/stress.out";
+    FILE* f = fopen(deepPath.c_str(), "wb");
+    FILE* g = fopen(limitPath.c_str(), "wb");
+    FILE* h = fopen(namesPath.c_str(), "wb");
+    if (f == NULL || g == NULL || h == NULL) {
+        fprintf(stderr, "Can't write the stress inputs in %s\n", dir.c_str());
+        return 2;
+    }
+    fwrite(deep.data(), 1, deep.size(), f);
+    fwrite(limit.data(), 1, limit.size(), g);
+    fwrite(names.data(), 1, names.size(), h);
+    fclose(f);
+    fclose(g);
+    fclose(h);
+
+    vector<StressCheck> checks;
+    StressCheck c;
+    c.name = "stack parser, depth " + to_string(depth);
+    c.input = deepPath;
+    c.options = {"--parser", "stack", "--max-nesting", "0", "--output", "summary"};
+    c.exitCode = 0;
+    c.expect = "Statements =\t4\n";
+    checks.push_back(c);
+    c.name = "stack parser, depth " + to_string(depth) + ", --fold --cse statement";
+    c.options.push_back("--fold");
+    c.options.push_back("--cse");
+    c.options.push_back("statement");
+    checks.push_back(c);
+    const char* parsers[] = {"recursive", "pratt", "stack"};
+    for (int k = 0; k < 3; k++) {
+        c.name = string(parsers[k]) + " parser, default limit at 4096/4097";
+        c.input = limitPath;
+        c.options = {"--parser", parsers[k], "--output", "summary", "--max-errors", "0"};
+        c.exitCode = 1;
+        c.expect = "Statements =\t3\n";
+        checks.push_back(c);
+    }
+    c.name = "keyword spellings are variable names";
+    c.input = namesPath;
+    c.options.clear();
+    c.exitCode = 0;
+    c.expect = "POSTFIX EXPRESSION-----------------------\ndo long + int = \n";
+    checks.push_back(c);
+
+    int failed = 0;
+    for (size_t i = 0; i < checks.size(); i++) {
+        vector<string> args(1, analyzer);
+        args.insert(args.end(), checks[i].options.begin(), checks[i].options.end());
+        args.push_back(checks[i].input);
+        double seconds = 0;
+        long peakKb = 0;
+        int exitCode = 0;
+        bool ran = runOnce(args, outputPath.c_str(), seconds, peakKb, exitCode);
+        string output = readFile(outputPath);
+//At the limit each of the three too-deep factors must be reported as nested too deeply, not as some other error.
+        bool ok = ran && exitCode == checks[i].exitCode && output.find(checks[i].expect) != string::npos;
+        if (ok && checks[i].exitCode == 1) {
+            size_t n = 0;
+            for (size_t at = output.find("nested more than 4096 levels deep"); at != string::npos; at = output.find("nested more than", at + 1)) n++;
+            ok = n == 3;
+        }
+        printf("%-6s %-60s %7.2f s %8.1f MB\n", ok ? "ok" : "FAILED", checks[i].name.c_str(), seconds, peakKb / 1024.0);
+        if (!ok) {
+            failed++;
+            printf("       exit %s, output starts:\n%.400s\n", ran ? to_string(exitCode).c_str() : "crashed", output.c_str());
+        }
+        fflush(stdout);
+    }
+    return failed > 0 ? 1 : 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc >= 4 && strcmp(argv[1], "gen") == 0) {
+        const Shape* shape = findShape(argv[2]);
+        if (shape == NULL) {
+            usage();
+            return 2;
+        }
+        unsigned long long seed = argc >= 5 ? strtoull(argv[4], NULL, 10) : 1;
+        string corpus = generate(*shape, strtoull(argv[3], NULL, 10), seed);
+        fwrite(corpus.data(), 1, corpus.size(), stdout);
+        return 0;
+    }
+    if (argc >= 2 && strcmp(argv[1], "run") == 0) return runBench(argc, argv);
+    if (argc >= 2 && strcmp(argv[1], "stress") == 0) return runStress(argc, argv);
+    usage();
+    return 2;
+}
@@ -1,411 +1,299 @@
 // Yutong Ye 12012842
 
 /* 
-use #include <stdio.h> to handle input/output, 
-#include <ctype.h> to check character types like letters or digits, 
-and #include <string.h> to work with strings like copying or comparing them.
+use #include <stdio.h> to handle input/output,
+#include <string.h> to work with strings like copying or comparing them,
+and #include "Lexer.h" for the shared lexer (build this file together with Lexer.cpp).
 */
 #include <stdio.h>
-#include <ctype.h>
 #include <string.h>
+#include "Lexer.h"
 
-/* 
-Global variable declarations 
-*/
-//These store the current character, its type, and build the token string.
-int charClass;
-char lexeme[100];
-char nextChar;
-//These track the token length and store current token codes.
-int lexLen;
-int token;
-int nextToken;
-//These are file pointers for reading input and writing output.
-FILE *in_fp;
-
-/* 
-Global Function declarations 
-*/
 
 /* 
-These three functions help prepare characters so the lexical analyzer can correctly build tokens.
-getChar() reads and classifies characters, getNonBlank() skips spaces, 
-and addChar() collects valid characters into the lexeme string.
+Output 
 */
-void addChar();
-void getChar();
-void getNonBlank();
 
 /*
-Declare int lex(); because it’s the main function that reads characters from the input 
-and builds valid tokens like identifiers, numbers, or operators, returning a token type so the parser knows what to do next.
+The driver can print tokens three ways: the full trace (one line per token, as always), a summary (token counts only),
+or a compact binary stream of fixed-size token records. All of them go through a Writer, which collects output in a large buffer
+and hands it to the C library in big pieces instead of one printf per token.
 */
-int lex();
+#define OUTPUT_FULL       0
+#define OUTPUT_SUMMARY    1
+#define OUTPUT_BINARY     2
 
+#define WRITER_SIZE       (1 << 16)
 
-/* Character classes 
-Define these to categorize each character as a letter, digit, 
-or unknown so the lexical analyzer knows how to process it when building tokens.
-*/
-#define LETTER 0
-#define DIGIT 1
-#define UNKNOWN 99
+//How many random buffers --self-test checks, and the seed it makes them from.
+#define SELF_TEST_BUFFERS 20000
+#define SELF_TEST_SEED    12012842
 
-/* Define these token codes to help the lexical analyzer recognize and label different types of words or numbers in the code, 
-like variables, constants, arrays, decimals, and keywords.
-*/
-#define INT_LIT           10    
-#define IDENT             11   
-#define ARRAY_ID          12   
-#define FLOAT_LIT         14   
-#define KEYWORD           15   
+struct Writer {
+    FILE *fp;
+    size_t len;
+    char buf[WRITER_SIZE];
+};
 
-/* 
-Separator token codes 
+/*
+A binary token record: the token code, the token size and its offset in the input file, in the machine's byte order.
+The stream starts with the 4 bytes "LEXB" and a 4-byte version number.
 */
+struct BinaryToken {
+    int code;
+    unsigned size;
+    unsigned long long offset;
+};
 
-// These define tokens for parentheses, used to group expressions.
-#define LEFT_PAREN        25   // (
-#define RIGHT_PAREN       26   // )
-// These define tokens for curly braces, used in blocks of code.
-#define LEFT_BRACE        125  // {
-#define RIGHT_BRACE       126  // }
-//These define tokens for comma and semicolon, used to separate values and end statements.
-#define COMMA             127  // ,
-#define SEMICOLON         128  // ;
+#define BINARY_VERSION    1
 
+void writer_put(Writer *w, const char *s, size_t n);
+void writer_puts(Writer *w, const char *s);
+void writer_int(Writer *w, long long v);
+void writer_flush(Writer *w);
 
-/* 
-Operator token codes 
+/******************************************************/
+/*
+Token codes
+
+The lexer prints the classic token codes for each TokenType; lexCodes gives the code of every type. The expression operators are
+never produced by the C dialect and share UNKNOWN's code.
+*/
+struct LexCodeTable {
+    int code[TOKEN_TYPE_COUNT];
+};
+
+constexpr LexCodeTable buildLexCodes() {
+    LexCodeTable t = {};
+    for (int i = 0; i < TOKEN_TYPE_COUNT; i++) t.code[i] = 99;
+/* These codes help the lexical analyzer recognize and label different types of words or numbers in the code, 
+like variables, constants, arrays, decimals, and keywords.
 */
-//These define token codes for basic math and assignment operators so the program can recognize and label them during analysis.
-#define ASSIGN_OP         220  // =
-#define ADD_OP            221  // +
-#define SUB_OP            222  // -
-#define MULT_OP           223  // *
-#define DIV_OP            224  // /
-//These define token codes for less common operators like power, unary minus, and modulo.
-#define POW_OP            227  // ^
-#define UNARY_MINUS       328  // ~
-#define MOD_OP            329  // %
+    t.code[INT_LIT] = 10;
+    t.code[IDENT] = 11;
+    t.code[ARRAY_ID] = 12;
+    t.code[FLOAT_LIT] = 14;
+    t.code[KEYWORD] = 15;
+// These are the codes for parentheses, used to group expressions, and curly braces, used in blocks of code.
+    t.code[LEFT_PAREN] = 25;
+    t.code[RIGHT_PAREN] = 26;
+    t.code[LEFT_BRACE] = 125;
+    t.code[RIGHT_BRACE] = 126;
+//These are the codes for comma and semicolon, used to separate values and end statements.
+    t.code[COMMA] = 127;
+    t.code[SEMICOLON] = 128;
+//These are the codes for basic math and assignment operators so the program can recognize and label them during analysis.
+    t.code[ASSIGN_OP] = 220;
+    t.code[ADD_OP] = 221;
+    t.code[SUB_OP] = 222;
+    t.code[MULT_OP] = 223;
+    t.code[DIV_OP] = 224;
+//These are the codes for less common operators like power, unary minus (~), and modulo.
+    t.code[POW_OP] = 227;
+    t.code[UNARY_MINUS] = 328;
+    t.code[MOD_OP] = 329;
 //These identify increment and decrement operators, used often in loops and counters.
-#define INC_OP            330  // ++
-#define DEC_OP            331  // --
+    t.code[INC_OP] = 330;
+    t.code[DEC_OP] = 331;
 //These represent compound assignment operators that combine math and assignment in one step.
-#define ADD_ASSIGN_OP     341  // +=
-#define SUB_ASSIGN_OP     342  // -=
-#define MULT_ASSIGN_OP    343  // *=
-#define DIV_ASSIGN_OP     344  // /=
-//These handle special compound operators like power-assign and modulo-assign.
-#define POW_ASSIGN_OP     347  // ^=
-#define MOD_ASSIGN_OP     349  // %=
+    t.code[ADD_ASSIGN_OP] = 341;
+    t.code[SUB_ASSIGN_OP] = 342;
+    t.code[MULT_ASSIGN_OP] = 343;
+    t.code[DIV_ASSIGN_OP] = 344;
+    t.code[POW_ASSIGN_OP] = 347;
+    t.code[MOD_ASSIGN_OP] = 349;
+//This is the special code -1 for the end of the input file, so the lexical analyzer knows when to stop reading characters.
+    t.code[END_OF_FILE] = -1;
+    return t;
+}
 
-//This line defines a special code −1 to represent the end of the input file, so the lexical analyzer knows when to stop reading characters.
-#define EOF_TOKEN         -1   
+constexpr LexCodeTable lexCodes = buildLexCodes();
 
 /******************************************************/
 /* main driver
    This is the entry point of the program. 
 */
 
-//This opens the input file for reading; if it fails, it prints an error and stops the program.
-int main() {
-    if ((in_fp = fopen("front.in", "r")) == NULL) {
+//This reads the options (--output full, summary or binary, --stats, --self-test, then the input file, front.in by default) and opens the input file for reading; if it fails, it prints an error and stops the program.
+int main(int argc, char *argv[]) {
+    const char *path = "front.in";
+    int mode = OUTPUT_FULL;
+    int stats = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "full") == 0) mode = OUTPUT_FULL;
+            else if (strcmp(argv[i], "summary") == 0) mode = OUTPUT_SUMMARY;
+            else if (strcmp(argv[i], "binary") == 0) mode = OUTPUT_BINARY;
+            else {
+                fprintf(stderr, "Unknown output mode %s (use full, summary or binary)\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--stats") == 0) {
+            stats = 1;
+        } else if (strcmp(argv[i], "--self-test") == 0) {
+//--self-test compares the SSE2/AVX2 run scanners with the plain C ones on random input instead of reading a file.
+            int versions = 0;
+            int mismatches = lexer_self_test(SELF_TEST_SEED, SELF_TEST_BUFFERS, &versions);
+            printf("Self-test: %d random buffers, %d scanner versions, %d mismatches\n", SELF_TEST_BUFFERS, versions, mismatches);
+            return mismatches == 0 ? 0 : 1;
+        } else {
+            path = argv[i];
+        }
+    }
+/*
+--stats times the phases of the run (loading the input, scanning, keyword lookups and output) and writes them as JSON on stderr at the end.
+Timing every token has a cost, so it is only built in with -DCOLLECT_STATS.
+*/
+#ifdef COLLECT_STATS
+    long long runStart = lexer_nanos();
+    long long scanNanos = 0;
+    long long tokens = 0;
+#else
+    if (stats) {
+        fprintf(stderr, "--stats needs a build with -DCOLLECT_STATS\n");
+        return 1;
+    }
+#endif
+    Lexer lx;
+    if (!lexer_open(&lx, path, LEX_C)) {
         printf("ERROR - cannot open flie\n");
         return 1;
     }
+#ifdef COLLECT_STATS
+    long long loadNanos = lexer_nanos() - runStart;
+#endif
+
+//All output goes through one buffered writer on stdout. The binary stream starts with its header.
+    static Writer out;
+    out.fp = stdout;
+    out.len = 0;
+    if (mode == OUTPUT_BINARY) {
+        unsigned version = BINARY_VERSION;
+        writer_put(&out, "LEXB", 4);
+        writer_put(&out, (const char *)&version, sizeof(version));
+    }
 
-
-/*Start by reading the first character. 
-Then, keep calling the lexical analyzer to analyze and print each token until we hit the end of the input file.
+/*
+Keep asking the lexer for tokens until we hit the end of the input file.
+In the full trace, characters that didn't fit into a lexeme are reported first, then the token code (from lexCodes) and lexeme.
+The summary only counts tokens per code (codes run from -1 to 349), and the binary stream writes one record per token.
 */
-    getChar();
+    static long long counts[351];
+    long long total = 0;
+    long long tooLong = 0;
+    LexToken tok;
     do {
-        lex();
-    } while (nextToken != EOF_TOKEN);   
-
-//Close both files and return 0 to show the program ran successfully.
-    fclose(in_fp);
-    return 0;
-}
-
-/*****************************************************/
-/* 
-Helper function: isEqual
-This function compares two strings character by character to determine if they are exactly the same.
-*/
-
-//Start by setting up an index i to compare characters in both strings one by one.
-int isEqual(const char *s1, const char *s2) {
-    int i = 0;
-//Loop through both strings and return false (0) if any character doesn’t match.
-    while (s1[i] != '\0' && s2[i] != '\0') {
-        if (s1[i] != s2[i]) {
-            return 0;  
+#ifdef COLLECT_STATS
+        long long scanStart = lexer_nanos();
+        lexer_next(&lx, &tok);
+        scanNanos += lexer_nanos() - scanStart;
+        if (tok.code != END_OF_FILE) tokens++;
+#else
+        lexer_next(&lx, &tok);
+#endif
+        int code = lexCodes.code[tok.code];
+        if (mode == OUTPUT_FULL) {
+            for (int i = 0; i < tok.dropped; i++) {
+                writer_puts(&out, "Error - lexeme is too long\n");
+            }
+            writer_puts(&out, "Token Num Code =\t");
+            writer_int(&out, code);
+            writer_puts(&out, "\tLexeme =\t");
+    // The lexeme is written as a C string (up to any NUL byte in it), just like printf("%s") did.
+            writer_puts(&out, tok.lexeme);
+            writer_put(&out, "\n", 1);
+    // Print for array identifiers
+            if (tok.code == ARRAY_ID) {
+                writer_puts(&out, ">> Found Array Identifier: ");
+                writer_puts(&out, tok.lexeme);
+                writer_put(&out, "\n", 1);
+            }
+        } else if (mode == OUTPUT_SUMMARY) {
+            counts[code + 1]++;
+            tooLong += tok.dropped;
+            if (tok.code != END_OF_FILE) total++;
+        } else {
+            BinaryToken rec;
+            rec.code = code;
+            rec.size = (unsigned)tok.size;
+            rec.offset = tok.offset;
+            writer_put(&out, (const char *)&rec, sizeof(rec));
+        }
+    } while (tok.code != END_OF_FILE);
+
+//The summary lists how many tokens of each code were found, the total, and how many characters didn't fit into a lexeme.
+    if (mode == OUTPUT_SUMMARY) {
+        for (int i = 0; i < 351; i++) {
+            if (counts[i] != 0) {
+                writer_puts(&out, "Token Num Code =\t");
+                writer_int(&out, i - 1);
+                writer_puts(&out, "\tCount =\t");
+                writer_int(&out, counts[i]);
+                writer_put(&out, "\n", 1);
+            }
         }
-        i++;
+        writer_puts(&out, "Total tokens =\t");
+        writer_int(&out, total);
+        writer_puts(&out, "\nLexemes too long =\t");
+        writer_int(&out, tooLong);
+        writer_put(&out, "\n", 1);
     }
-//After looping, return true 1 only if both are the same.
-    return s1[i] == '\0' && s2[i] == '\0';  
-}
-/*
-checkKeyword() ensures accurate token classification by checking if a lexeme is a keyword.
-*/
 
-//These lines check if the word is a type related keyword like int, short, or long.
-int checkKeyword(const char* word) {
-    if (isEqual(word, "int")) return KEYWORD;
-    else if (isEqual(word, "short")) return KEYWORD;
-    else if (isEqual(word, "long")) return KEYWORD;
-//These check for numeric type keywords that tell how numbers should be stored.
-    else if (isEqual(word, "signed")) return KEYWORD;
-    else if (isEqual(word, "unsigned")) return KEYWORD;
-    else if (isEqual(word, "float")) return KEYWORD;
-//These lines look for more reserved words used in C like double, const, and do.
-    else if (isEqual(word, "double")) return KEYWORD;
-    else if (isEqual(word, "const")) return KEYWORD;
-    else if (isEqual(word, "do")) return KEYWORD;
-//These lines check if the word is a control flow keyword. 
-    else if (isEqual(word, "else")) return KEYWORD;
-    else if (isEqual(word, "for")) return KEYWORD;
-    else if (isEqual(word, "if")) return KEYWORD;
-//These check for switch and while, which are also control flow keywords.
-    else if (isEqual(word, "switch")) return KEYWORD;
-    else if (isEqual(word, "while")) return KEYWORD;
-    else return IDENT;
+//Flush the output, release the input buffer and return 0 to show the program ran successfully.
+    writer_flush(&out);
+#ifdef COLLECT_STATS
+//Output is everything after loading that wasn't scanning; scanning does not count the keyword lookups.
+    if (stats) {
+        long long wall = lexer_nanos() - runStart;
+        double seconds = wall / 1e9;
+        fprintf(stderr, "{\"tool\": \"lexer\", \"input_bytes\": %zu, \"wall_seconds\": %.6f,\n", lx.in_size, seconds);
+        fprintf(stderr, " \"phases\": {\"load\": %.6f, \"scan\": %.6f, \"keyword_lookup\": %.6f, \"output\": %.6f},\n", loadNanos / 1e9,
+                (scanNanos - lx.keywordNanos) / 1e9, lx.keywordNanos / 1e9, (wall - loadNanos - scanNanos) / 1e9);
+        fprintf(stderr, " \"tokens\": %lld, \"tokens_per_second\": %.0f, \"keyword_lookups\": %lld, \"bytes_per_second\": %.0f}\n", tokens,
+                seconds > 0 ? tokens / seconds : 0.0, lx.keywordLookups, seconds > 0 ? lx.in_size / seconds : 0.0);
+    }
+#endif
+    lexer_close(&lx);
+    return 0;
 }
 
-
 /*****************************************************/
 /* 
-Lexical analyzer functions 
+Output functions 
 */
 
-// Starts a switch to match symbols like +, -, etc. to their token codes.
-int lookup(char ch) {
-    switch (ch) {
-//Handles all versions of +: regular +, ++, and += so we know what kind of operation it is.
-        case '+':
-            addChar(); getChar();
-            if (nextChar == '+') { addChar(); nextToken = INC_OP; getChar(); }
-            else if (nextChar == '=') { addChar(); nextToken = ADD_ASSIGN_OP; getChar(); }
-            else nextToken = ADD_OP;
-            break;
-//Same idea for -: it checks for --, -=, or just -.
-        case '-':
-            addChar(); getChar();
-            if (nextChar == '-') { addChar(); nextToken = DEC_OP; getChar(); }
-            else if (nextChar == '=') { addChar(); nextToken = SUB_ASSIGN_OP; getChar(); }
-            else nextToken = SUB_OP;
-            break;
-//Handles multiplication * and multiply-assign *=.
-        case '*':
-            addChar(); getChar();
-            if (nextChar == '=') { addChar(); nextToken = MULT_ASSIGN_OP; getChar(); }
-            else nextToken = MULT_OP;
-            break;
-//Handles / and /=, so we know if it's division or assign divide.
-        case '/':
-            addChar(); getChar();
-            if (nextChar == '=') { addChar(); nextToken = DIV_ASSIGN_OP; getChar(); }
-            else nextToken = DIV_OP;
-            break;
-//Handles modulo % and %= so we can tokenize them properly.
-        case '%':
-            addChar(); getChar();
-            if (nextChar == '=') { addChar(); nextToken = MOD_ASSIGN_OP; getChar(); }
-            else nextToken = MOD_OP;
-            break;
-
-//Handles power ^ and power-assign ^=.
-        case '^':
-            addChar(); getChar();
-            if (nextChar == '=') { addChar(); nextToken = POW_ASSIGN_OP; getChar(); }
-            else nextToken = POW_OP;
-//Handles the ~ unary minus operator and sets the right token.
-            break;
-        case '~':
-            addChar(); getChar();
-            nextToken = UNARY_MINUS;
-            break;
-//Handles single equal sign =, used for assignments.
-        case '=':
-            addChar(); getChar();
-            nextToken = ASSIGN_OP;
-            break;
-//Marks ( as a left parenthesis separator.
-        case '(':
-            addChar(); getChar();
-            nextToken = LEFT_PAREN;
-            break;
-//Marks ) as a right parenthesis separator.
-        case ')':
-            addChar(); getChar();
-            nextToken = RIGHT_PAREN;
-            break;
-//Handles { for code block opening.
-        case '{':
-            addChar(); getChar();
-            nextToken = LEFT_BRACE;
-            break;
-//Handles } for code block closing.
-        case '}':
-            addChar(); getChar();
-            nextToken = RIGHT_BRACE;
-            break;
-//Handles comma ,, often used in argument lists or variable declarations.
-        case ',':
-            addChar(); getChar();
-            nextToken = COMMA;
-            break;
-//Handles semicolon ;, used to end statements.
-        case ';':
-            addChar(); getChar();
-            nextToken = SEMICOLON;
-            break;
-//Catches anything not defined above and marks it as UNKNOWN.
-        default:
-            addChar(); getChar();
-            nextToken = UNKNOWN;
-            break;
+//writer_put() copies bytes into the buffer and only calls fwrite() when the buffer is full (or the piece is bigger than the buffer).
+void writer_put(Writer *w, const char *s, size_t n) {
+    if (w->len + n > WRITER_SIZE) {
+        writer_flush(w);
+        if (n > WRITER_SIZE) {
+            fwrite(s, 1, n, w->fp);
+            return;
+        }
     }
-//Returns the final token code so it can be used by lex() and printed/output.
-    return nextToken;
+    memcpy(w->buf + w->len, s, n);
+    w->len += n;
 }
 
-/*
-We need addChar() to safely add each valid character to the current token lexeme and make sure it forms a proper string for processing.
-*/
-void addChar() {
-    if (lexLen <= 98) {
-        lexeme[lexLen++] = nextChar;
-        lexeme[lexLen] = '\0';
-    } else {
-        printf("Error - lexeme is too long\n");
-    }
+void writer_puts(Writer *w, const char *s) {
+    writer_put(w, s, strlen(s));
 }
 
-//The getChar() function is responsible for reading the next character from the input file and classifying it into one of the defined character classes
-void getChar() {
-//Reads the next character from the file and checks if it's not the end of the file.
-    if ((nextChar = getc(in_fp)) != EOF) {
-// Check if the character is a letter (A-Z or a-z)
-        if ((nextChar >= 'a' && nextChar <= 'z') || 
-            (nextChar >= 'A' && nextChar <= 'Z')) {
-            charClass = LETTER;
-// If not a letter, check if it's a digit (0-9)
-        } else if (nextChar >= '0' && nextChar <= '9') {
-            charClass = DIGIT;
-// If it's neither a letter nor a digit, treat it as unknown 
-        } else {
-            charClass = UNKNOWN;
-        }
-    } else {
-// If nothing left to read, mark it as end of file
-        nextChar = EOF; 
-        charClass = EOF;
-    }
+//writer_int() formats a number by hand, since snprintf() per token would cost more than the rest of the output.
+void writer_int(Writer *w, long long v) {
+    char digits[24];
+    int n = 0;
+    unsigned long long u = v < 0 ? 0ULL - (unsigned long long)v : (unsigned long long)v;
+    do {
+        digits[sizeof(digits) - 1 - n++] = (char)('0' + u % 10);
+        u /= 10;
+    } while (u != 0);
+    if (v < 0) digits[sizeof(digits) - 1 - n++] = '-';
+    writer_put(w, digits + sizeof(digits) - n, (size_t)n);
 }
 
-//This function getNonBlank() to skip over spaces, tabs, and newlines so the lexical analyzer only looks at real code, not empty space.
-void getNonBlank() {
-    while (isspace(nextChar)) {
-        getChar();
-    }
+void writer_flush(Writer *w) {
+    fwrite(w->buf, 1, w->len, w->fp);
+    w->len = 0;
 }
-
-/*
-This starts the lex() function to reset the lexeme length and skip any whitespace before starting to build the next token.
-*/
-int lex() {
-    lexLen = 0;
-    getNonBlank();
-
-/*
-This part checks if we reached the end of the file.
-If so, we stop analyzing and mark it with a special EOF token so the parser knows there’s no more input to read.
-*/
-
-    if (charClass == EOF) {
-        nextToken = EOF_TOKEN;
-        strcpy(lexeme, "EOF");
-        printf("Token Num Code =\t%d\tLexeme =\t%s\n", nextToken, lexeme);
-        return nextToken;
-    }
-
-
-    // This starts the case where the current character is a letter, so we assume it could be an identifier or keyword and begin building the word.
-    switch (charClass) {
-        case LETTER:
-            addChar();
-            getChar();
-    //This loop keeps adding characters to the word as long as they are letters or digits, forming the full identifier or keyword.
-            while (charClass == LETTER || charClass == DIGIT) {
-                addChar();
-                getChar();
-            }
-    //After the word is built, this line checks if it's a keyword or just a regular variable name and assigns the right token code.
-            nextToken = checkKeyword(lexeme);
-            break;
-
-    //Starts building a number by adding the first digit and continues adding digits if more are found.
-        case DIGIT:
-            addChar();
-            getChar();
-            while (charClass == DIGIT) {
-                addChar();
-                getChar();
-            }
-    // Checks if there’s a decimal point after the digits to see if it’s a floating point number.
-            if (nextChar == '.') {
-                addChar();
-                getChar();
-    //If there is a digit after the dot, continue collecting the rest of the floating point number.
-                if (charClass == DIGIT) {
-                    while (charClass == DIGIT) {
-                        addChar();
-                        getChar();
-                    }
-    //Sets the token type as a float if valid, or UNKNOWN if the dot isn't followed by a digit.
-                    nextToken = FLOAT_LIT;
-                } else {
-                    nextToken = UNKNOWN;
-                }
-            } else {
-    //If no dot is found, it's just an integer. If the character is not a digit or letter, handle it as UNKNOWN.
-                nextToken = INT_LIT;
-            }
-            break;
-
-        case UNKNOWN:
-    //Looks up operators and punctuation using lookup() when the character type is unknown.
-            nextToken = lookup(nextChar);
-            break;
-    }
-
-    //To check if an identifier is immediately followed by a valid array index in square brackets
-        if (nextToken == IDENT && nextChar == '[') {
-            addChar(); getChar(); 
-            if (charClass == DIGIT) {
-                while (charClass == DIGIT) {
-                    addChar(); getChar();
-                }
-                if (nextChar == ']') {
-                    addChar(); getChar(); 
-                    nextToken = ARRAY_ID;
-                }
-            }
-        }
-
-
-    // Print token type and lexeme
-    printf("Token Num Code =\t%d\tLexeme =\t%s\n", nextToken, lexeme);
-
-    // Print for array identifiers
-    if (nextToken == ARRAY_ID) {
-        printf(">> Found Array Identifier: %s\n", lexeme);
-    }
-
-    //Return nextToken at the end of the lex() function to send the identified token code back to the parser
-    return nextToken;
-}
\ No newline at end of file